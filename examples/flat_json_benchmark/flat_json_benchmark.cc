@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kero/core/flat_json.h"
+#include "kero/core/flat_json_binary.h"
+#include "kero/core/flat_json_parser.h"
+#include "kero/log/center.h"
+
+using namespace kero;
+
+struct Message {
+  const char* name;
+  FlatJson json;
+};
+
+auto
+MakeMessages() -> std::vector<Message> {
+  std::vector<Message> messages{};
+  messages.push_back(Message{
+      "battle_action",
+      FlatJson{}.Set("__event", "battle_action").Set("action", 3).Take()});
+  messages.push_back(Message{"battle_result",
+                             FlatJson{}
+                                 .Set("event", "battle_result")
+                                 .Set("result", 1)
+                                 .Set("round", 2)
+                                 .Set("wins", 1)
+                                 .Set("losses", 0)
+                                 .Take()});
+  messages.push_back(Message{"battle_start",
+                             FlatJson{}
+                                 .Set("event", "battle_start")
+                                 .Set("battle_id", u64{123456789})
+                                 .Set("opponent_socket_id", 42)
+                                 .Set("rating", 1512.5)
+                                 .Set("ready", true)
+                                 .Take()});
+  return messages;
+}
+
+template <typename F>
+auto
+MeasureNs(const size_t count, F&& f) -> double {
+  const auto started_at = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    f();
+  }
+
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - started_at)
+             .count() /
+         static_cast<double>(count);
+}
+
+/**
+ * Compares the text and binary payloads of a few typical messages: bytes per
+ * message, and encode and decode time per message. Binary keys are interned
+ * by the first message of a connection, so both its first and its later sizes
+ * are shown.
+ */
+auto
+main(int argc, char** argv) -> int {
+  const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  size_t sink{};
+
+  for (const auto& [name, json] : MakeMessages()) {
+    auto text_res = FlatJsonStringifier{}.Stringify(json);
+    if (text_res.IsErr()) {
+      std::cerr << name << ": " << text_res.TakeErr() << "\n";
+      return 1;
+    }
+
+    const auto text = text_res.TakeOk();
+    const auto stringify_ns = MeasureNs(count, [&json, &sink] {
+      sink += FlatJsonStringifier{}.Stringify(json).Ok().size();
+    });
+    const auto parse_ns = MeasureNs(count, [&text, &sink] {
+      sink += FlatJsonParser{}.Parse(text).Ok().AsRaw().size();
+    });
+
+    FlatJsonBinaryEncoder encoder{};
+    FlatJsonBinaryDecoder decoder{};
+    std::string first;
+    encoder.Encode(json, first);
+    (void)decoder.Decode(first);
+
+    std::string binary;
+    encoder.Encode(json, binary);
+    const auto encode_ns = MeasureNs(count, [&encoder, &json, &sink] {
+      std::string output;
+      encoder.Encode(json, output);
+      sink += output.size();
+    });
+    const auto decode_ns = MeasureNs(count, [&decoder, &binary, &sink] {
+      sink += decoder.Decode(binary).Ok().AsRaw().size();
+    });
+
+    std::cout << name << ":\n"
+              << "  text:   " << text.size() << " bytes, stringify "
+              << stringify_ns << " ns, parse " << parse_ns << " ns, "
+              << static_cast<double>(text.size()) / parse_ns
+              << " bytes/ns parsed\n"
+              << "  binary: " << binary.size() << " bytes (" << first.size()
+              << " first), encode " << encode_ns << " ns, decode "
+              << decode_ns << " ns, "
+              << static_cast<double>(binary.size()) / decode_ns
+              << " bytes/ns decoded\n";
+  }
+
+  Center{}.Shutdown();
+  return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "kero/core/flat_json.h"
+#include "kero/core/frame_codec.h"
+#include "kero/core/frame_template.h"
+#include "kero/log/center.h"
+
+using namespace kero;
+
+struct Response {
+  const char* name;
+  FrameTemplate frame_template;
+  std::array<u64, 4> values;
+  std::function<FlatJson(const std::array<u64, 4>&)> build;
+};
+
+struct Format {
+  const char* name;
+  WireFormat wire_format;
+};
+
+template <typename F>
+auto
+MeasurePerSecond(const size_t count, F&& f) -> double {
+  const auto started_at = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    f(i);
+  }
+
+  return static_cast<double>(count) /
+         std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       started_at)
+             .count();
+}
+
+/**
+ * Responses per second on one core for the hot battle replies, built as a
+ * `FlatJson` and encoded, and rendered from a `FrameTemplate`, in each wire
+ * format a client may ask for. The values change every response, as they do
+ * in a battle.
+ */
+auto
+main(int argc, char** argv) -> int {
+  const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500000;
+
+  std::array responses{
+      Response{
+          "battle_start",
+          FrameTemplate{R"({"event":"battle_start","battle_id":$,)"
+                        R"("opponent_socket_id":$})"},
+          {123456789, 42},
+          [](const std::array<u64, 4>& values) {
+            return FlatJson{}
+                .Set("event", "battle_start")
+                .Set("battle_id", values[0])
+                .Set("opponent_socket_id", values[1])
+                .Take();
+          }},
+      Response{
+          "battle_result",
+          FrameTemplate{R"({"event":"battle_result","result":$,"round":$,)"
+                        R"("wins":$,"losses":$})"},
+          {1, 2, 1, 0},
+          [](const std::array<u64, 4>& values) {
+            return FlatJson{}
+                .Set("event", "battle_result")
+                .Set("result", values[0])
+                .Set("round", values[1])
+                .Set("wins", values[2])
+                .Set("losses", values[3])
+                .Take();
+          }},
+  };
+  const std::array formats{
+      Format{"text, brace", {}},
+      Format{"text, length prefixed",
+             {.frame = FrameFormat::kLengthPrefixed,
+              .payload = PayloadFormat::kFlatJsonText}},
+      Format{"binary, length prefixed",
+             {.frame = FrameFormat::kLengthPrefixed,
+              .payload = PayloadFormat::kFlatJsonBinary}},
+  };
+
+  size_t sink{};
+  for (auto& [name, frame_template, values, build] : responses) {
+    std::cout << name << ":\n";
+    for (const auto& [format_name, wire_format] : formats) {
+      SocketCodec codec{};
+      (void)codec.SwitchWriteFormat(wire_format);
+
+      auto varied = values;
+      const auto flat_json_per_second = MeasurePerSecond(count, [&](size_t i) {
+        varied[0] = values[0] + i;
+        sink += codec.EncodeFrame(build(varied)).Ok().size();
+      });
+      const auto template_per_second = MeasurePerSecond(count, [&](size_t i) {
+        varied[0] = values[0] + i;
+        sink += codec.EncodeFrame(frame_template, varied).Ok().size();
+      });
+
+      std::cout << "  " << format_name << ": FlatJson "
+                << flat_json_per_second / 1000 << "k/s, template "
+                << template_per_second / 1000 << "k/s ("
+                << template_per_second / flat_json_per_second << "x)\n";
+    }
+  }
+
+  Center{}.Shutdown();
+  return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "kero/log/core.h"
+#include "kero/log/crash_handler.h"
+#include "kero/log/global_context.h"
+#include "kero/log/log_queue.h"
+#include "kero/log/log_record.h"
+#include "kero/log/mapped_ring_transport.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+[[nodiscard]] auto
+ReadFile(const std::string& path) -> std::string {
+  std::ifstream file{path};
+  return std::string{std::istreambuf_iterator<char>{file},
+                     std::istreambuf_iterator<char>{}};
+}
+
+[[nodiscard]] auto
+GetSlot(const std::string& file,
+        const size_t slot_size,
+        const size_t index) -> std::string_view {
+  return std::string_view{file}.substr(
+      MappedRingTransport::kHeaderSize + index * slot_size, slot_size);
+}
+
+[[nodiscard]] auto
+IsZeroPaddedLine(const std::string_view slot) -> bool {
+  const auto end = slot.find('\n');
+  return end != std::string_view::npos &&
+         slot.find_first_not_of('\0', end + 1) == std::string_view::npos;
+}
+
+struct Crashed final {
+  int status{};
+  std::string output{};
+};
+
+/**
+ * Runs `crash` in a child, which is given the fd to install the crash
+ * handler on, and returns how the child ended and what it wrote there. The
+ * child has no log thread, so records it queues stay queued until it
+ * crashes.
+ */
+[[nodiscard]] auto
+RunCrashingChild(const std::function<void(int)>& crash)
+    -> std::optional<Crashed> {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    return std::nullopt;
+  }
+
+  const auto pid = ::fork();
+  if (pid == 0) {
+    ::close(fds[0]);
+    crash(fds[1]);
+    ::_exit(2);
+  }
+
+  ::close(fds[1]);
+  Crashed crashed{};
+  char buffer[4096];
+  for (ssize_t size{}; (size = ::read(fds[0], buffer, sizeof(buffer))) > 0;) {
+    crashed.output.append(buffer, static_cast<size_t>(size));
+  }
+
+  ::close(fds[0]);
+  if (pid < 0 || ::waitpid(pid, &crashed.status, 0) != pid) {
+    return std::nullopt;
+  }
+
+  return crashed;
+}
+
+}  // namespace
+
+KERO_TEST(MappedRingTransportKeepsTheLatestLogs) {
+  constexpr u32 kSlotCount{4};
+  constexpr u32 kSlotSize{256};
+  char dir[] = "/tmp/kero_test_XXXXXX";
+  if (!KERO_CHECK(::mkdtemp(dir) != nullptr)) {
+    return;
+  }
+
+  const std::string path = std::string{dir} + "/ring";
+  const auto build = [&path] {
+    return MappedRingTransport::Builder{}.Build(MappedRingOptions{
+        .path = path, .slot_count = kSlotCount, .slot_size = kSlotSize});
+  };
+
+  {
+    auto transport = build();
+    if (!KERO_CHECK(transport.IsOk())) {
+      return;
+    }
+
+    for (u32 i = 0; i < 6; ++i) {
+      transport.Ok()->OnLog(
+          Log{"log " + std::to_string(i), {}, Level::kInfo});
+    }
+  }
+
+  // Logs 4 and 5 overwrote 0 and 1.
+  auto file = ReadFile(path);
+  KERO_CHECK(file.size() ==
+             MappedRingTransport::kHeaderSize + kSlotCount * kSlotSize);
+  KERO_CHECK(file.starts_with("KERORING"));
+  const char* const expected[] = {"log 4", "log 5", "log 2", "log 3"};
+  for (size_t i = 0; i < kSlotCount; ++i) {
+    const auto slot = GetSlot(file, kSlotSize, i);
+    KERO_CHECK(slot.find(std::string{'"'} + expected[i] + '"') !=
+               std::string_view::npos);
+    KERO_CHECK(IsZeroPaddedLine(slot));
+  }
+
+  // The same geometry continues where the last run stopped, and a line
+  // longer than a slot is cut.
+  {
+    auto transport = build();
+    if (!KERO_CHECK(transport.IsOk())) {
+      return;
+    }
+
+    transport.Ok()->OnLog(Log{std::string(1000, 'x'), {}, Level::kInfo});
+  }
+
+  file = ReadFile(path);
+  const auto cut = GetSlot(file, kSlotSize, 2);
+  KERO_CHECK(cut.find("xxx") != std::string_view::npos);
+  KERO_CHECK(cut.find('\n') == kSlotSize - 2);
+  KERO_CHECK(IsZeroPaddedLine(cut));
+  KERO_CHECK(GetSlot(file, kSlotSize, 3).find("\"log 3\"") !=
+             std::string_view::npos);
+
+  ::unlink(path.c_str());
+  ::rmdir(dir);
+}
+
+KERO_TEST(CrashHandlerWritesQueuedLogs) {
+  auto& global_context = GetGlobalContext();
+  auto log_queue = std::make_shared<LogQueue>(LogQueueOptions{});
+  const auto ordinal = global_context.AddLogQueue(log_queue);
+  if (!KERO_CHECK(ordinal.has_value())) {
+    return;
+  }
+
+  const auto crashed = RunCrashingChild([&log_queue, &ordinal](const int fd) {
+    LogRecord record{};
+    record.level = Level::kError;
+    record.thread_ordinal = *ordinal;
+    record.message = record.AppendText("About to crash");
+    if (auto* const field = record.AddField("answer")) {
+      field->value = u64{42};
+    }
+
+    if (!log_queue->Push(record) || InstallCrashHandler(fd).IsErr()) {
+      ::_exit(1);
+    }
+
+    std::raise(SIGSEGV);
+  });
+  std::ignore = global_context.RemoveLogQueue(*ordinal);
+  if (!KERO_CHECK(crashed.has_value())) {
+    return;
+  }
+
+  const auto& [status, output] = *crashed;
+  KERO_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+  KERO_CHECK(output.starts_with("Fatal signal " + std::to_string(SIGSEGV)));
+  KERO_CHECK(output.find("[thread " + std::to_string(*ordinal) +
+                         "] About to crash answer=42") != std::string::npos);
+  KERO_CHECK(output.ends_with("Queued logs written\n"));
+}
+
+KERO_TEST(CrashHandlerLetsOneThreadWriteAtATime) {
+  constexpr size_t kRecordCount{256};
+  constexpr size_t kThreadCount{4};
+  auto& global_context = GetGlobalContext();
+  auto log_queue = std::make_shared<LogQueue>(LogQueueOptions{});
+  const auto ordinal = global_context.AddLogQueue(log_queue);
+  if (!KERO_CHECK(ordinal.has_value())) {
+    return;
+  }
+
+  // Threads crash at once with the same signal while the first writes.
+  const auto crashed = RunCrashingChild([&log_queue](const int fd) {
+    LogRecord record{};
+    record.level = Level::kError;
+    record.message = record.AppendText(std::string(1024, 'x'));
+    for (size_t i = 0; i < kRecordCount; ++i) {
+      if (!log_queue->Push(record)) {
+        ::_exit(1);
+      }
+    }
+
+    if (InstallCrashHandler(fd).IsErr()) {
+      ::_exit(1);
+    }
+
+    std::latch ready{kThreadCount};
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < kThreadCount; ++i) {
+      threads.emplace_back([&ready] {
+        ready.arrive_and_wait();
+        std::raise(SIGSEGV);
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  });
+  std::ignore = global_context.RemoveLogQueue(*ordinal);
+  if (!KERO_CHECK(crashed.has_value())) {
+    return;
+  }
+
+  const auto& [status, output] = *crashed;
+  size_t header_count{};
+  for (auto i = output.find("Fatal signal"); i != std::string::npos;
+       i = output.find("Fatal signal", i + 1)) {
+    ++header_count;
+  }
+
+  size_t record_count{};
+  for (auto i = output.find(" ERROR "); i != std::string::npos;
+       i = output.find(" ERROR ", i + 1)) {
+    ++record_count;
+  }
+
+  KERO_CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+  KERO_CHECK(header_count == 1);
+  KERO_CHECK(record_count == kRecordCount);
+  KERO_CHECK(output.ends_with("Queued logs written\n"));
+}
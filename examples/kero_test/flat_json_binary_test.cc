@@ -0,0 +1,192 @@
+#include <array>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "kero/core/flat_json.h"
+#include "kero/core/flat_json_binary.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+/**
+ * Random objects over a key pool larger than `kMaxInternedKeys`, so both
+ * interned and literal keys are sent once the table is full.
+ */
+class RandomFlatJson final {
+ public:
+  explicit RandomFlatJson(const u32 seed) noexcept : engine_{seed} {}
+
+  auto
+  Next() noexcept -> FlatJson {
+    FlatJson json{};
+    const auto field_count = Uniform(0, 12);
+    for (u64 i = 0; i < field_count; ++i) {
+      auto key = "key_" + std::to_string(Uniform(0, kKeyPoolSize - 1));
+      switch (Uniform(0, 4)) {
+        case 0:
+          (void)json.TrySet(std::move(key), Uniform(0, 1) == 1);
+          break;
+        case 1:
+          (void)json.TrySet(std::move(key), NextInteger());
+          break;
+        case 2:
+          (void)json.TrySet(std::move(key), NextDouble());
+          break;
+        default:
+          (void)json.TrySet(std::move(key), NextString());
+          break;
+      }
+    }
+
+    return json;
+  }
+
+  static constexpr u64 kKeyPoolSize{FlatJsonBinary::kMaxInternedKeys * 2};
+
+ private:
+  auto
+  Uniform(const u64 min, const u64 max) noexcept -> u64 {
+    return std::uniform_int_distribution<u64>{min, max}(engine_);
+  }
+
+  /**
+   * Integers of every varint length, and both edges of the safe range.
+   */
+  auto
+  NextInteger() noexcept -> double {
+    constexpr std::array kEdges{0.0,
+                                -1.0,
+                                FlatJson::kMaxSafeInteger,
+                                FlatJson::kMinSafeInteger};
+    if (Uniform(0, 7) == 0) {
+      return kEdges[Uniform(0, kEdges.size() - 1)];
+    }
+
+    const auto bits = Uniform(0, 52);
+    const auto magnitude =
+        static_cast<double>(Uniform(0, (u64{1} << bits) - 1));
+    return Uniform(0, 1) == 0 ? magnitude : -magnitude;
+  }
+
+  /**
+   * NaN is left out, it never equals itself.
+   */
+  auto
+  NextDouble() noexcept -> double {
+    constexpr std::array kEdges{std::numeric_limits<double>::infinity(),
+                                -std::numeric_limits<double>::infinity(),
+                                std::numeric_limits<double>::denorm_min(),
+                                FlatJson::kMaxSafeInteger + 2.0};
+    if (Uniform(0, 7) == 0) {
+      return kEdges[Uniform(0, kEdges.size() - 1)];
+    }
+
+    return std::uniform_real_distribution<double>{-1e9, 1e9}(engine_);
+  }
+
+  /**
+   * Any byte, `\0` included.
+   */
+  auto
+  NextString() noexcept -> std::string {
+    std::string str(Uniform(0, 40), '\0');
+    for (auto& c : str) {
+      c = static_cast<char>(Uniform(0, 255));
+    }
+
+    return str;
+  }
+
+  std::mt19937_64 engine_;
+};
+
+}  // namespace
+
+KERO_TEST(FlatJsonBinaryRoundTrip) {
+  RandomFlatJson random{42};
+  FlatJsonBinaryEncoder encoder{};
+  FlatJsonBinaryDecoder decoder{};
+  std::string encoded;
+  for (u32 i = 0; i < 20000; ++i) {
+    const auto json = random.Next();
+    encoded.clear();
+    encoder.Encode(json, encoded);
+
+    auto decoded = decoder.Decode(encoded);
+    if (!KERO_CHECK(decoded.IsOk())) {
+      return;
+    }
+
+    if (!KERO_CHECK(decoded.Ok().AsRaw() == json.AsRaw())) {
+      return;
+    }
+  }
+
+  KERO_CHECK(encoder.GetKeys().size() == FlatJsonBinary::kMaxInternedKeys);
+  KERO_CHECK(encoder.GetKeys() == decoder.GetKeys());
+}
+
+KERO_TEST(FlatJsonBinaryInternsKeys) {
+  FlatJsonBinaryEncoder encoder{};
+  const auto json = FlatJson{}.Set("battle_id", 7).Set("round", 2).Take();
+
+  std::string first;
+  encoder.Encode(json, first);
+  std::string second;
+  encoder.Encode(json, second);
+  KERO_CHECK(second.size() < first.size());
+
+  // A restored table picks up where the exported one left off.
+  FlatJsonBinaryDecoder decoder{};
+  KERO_CHECK(decoder.Decode(first).IsOk());
+  FlatJsonBinaryDecoder restored{std::vector<std::string>{decoder.GetKeys()}};
+  auto decoded = restored.Decode(second);
+  KERO_CHECK(decoded.IsOk() && decoded.Ok().AsRaw() == json.AsRaw());
+}
+
+KERO_TEST(FlatJsonBinaryRejectsTruncatedInput) {
+  RandomFlatJson random{7};
+  FlatJsonBinaryEncoder encoder{};
+  FlatJsonBinaryDecoder decoder{};
+  std::string encoded;
+  for (u32 i = 0; i < 300; ++i) {
+    const auto json = random.Next();
+    encoded.clear();
+    encoder.Encode(json, encoded);
+
+    // Every strict prefix of an object is cut inside a field.
+    for (size_t size = 0; size < encoded.size(); ++size) {
+      FlatJsonBinaryDecoder copy{std::vector<std::string>{decoder.GetKeys()}};
+      if (!KERO_CHECK(copy.Decode(encoded.substr(0, size)).IsErr())) {
+        return;
+      }
+    }
+
+    FlatJsonBinaryDecoder copy{std::vector<std::string>{decoder.GetKeys()}};
+    KERO_CHECK(copy.Decode(encoded + '\0').IsErr());
+    KERO_CHECK(decoder.Decode(encoded).IsOk());
+  }
+}
+
+KERO_TEST(FlatJsonBinarySurvivesGarbage) {
+  std::mt19937_64 engine{1234};
+  std::uniform_int_distribution<u32> byte{0, 255};
+  std::uniform_int_distribution<u32> size{0, 64};
+  FlatJsonBinaryDecoder decoder{};
+  for (u32 i = 0; i < 20000; ++i) {
+    std::string input(size(engine), '\0');
+    for (auto& c : input) {
+      c = static_cast<char>(byte(engine));
+    }
+
+    // Only has to fail cleanly or decode something.
+    (void)decoder.Decode(input);
+  }
+
+  KERO_CHECK(decoder.GetKeys().size() <= FlatJsonBinary::kMaxInternedKeys);
+}
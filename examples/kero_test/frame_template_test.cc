@@ -0,0 +1,60 @@
+#include <array>
+#include <string>
+
+#include "kero/core/flat_json_parser.h"
+#include "kero/core/frame_template.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+/**
+ * Whether `ToFlatJson` holds what parsing the rendered payload would.
+ */
+[[nodiscard]] auto
+MatchesRendered(const FrameTemplate& frame_template,
+                const std::span<const u64> values) -> bool {
+  std::string payload;
+  frame_template.Render(values, payload);
+  auto parsed = FlatJsonParser{}.Parse(payload);
+  auto data = frame_template.ToFlatJson(values);
+  return KERO_CHECK(parsed.IsOk()) && KERO_CHECK(data.IsOk()) &&
+         parsed.Ok().AsRaw() == data.Ok().AsRaw();
+}
+
+}  // namespace
+
+KERO_TEST(FrameTemplateRendersValuesInSlots) {
+  const FrameTemplate frame_template{
+      R"({"event":"battle_result","result":$,"round":$})"};
+  KERO_CHECK(frame_template.GetSlotCount() == 2);
+
+  std::string payload{"prefix"};
+  constexpr std::array<u64, 2> kValues{1, 18446744073709551615u};
+  frame_template.Render(kValues, payload);
+  KERO_CHECK(payload ==
+             R"(prefix{"event":"battle_result","result":1,)"
+             R"("round":18446744073709551615})");
+
+  // Slots without a value hold zero.
+  payload.clear();
+  frame_template.Render(std::span<const u64>{kValues}.first(1), payload);
+  KERO_CHECK(payload == R"({"event":"battle_result","result":1,"round":0})");
+}
+
+KERO_TEST(FrameTemplateToFlatJsonMatchesRenderedPayload) {
+  constexpr std::array<u64, 3> kValues{7, 0, 123456789};
+  KERO_CHECK(MatchesRendered(
+      FrameTemplate{R"({"event":"battle_start","battle_id":$,"opp":$})"},
+      kValues));
+  KERO_CHECK(MatchesRendered(
+      FrameTemplate{R"({ "a" : $ , "flag":true, "b":$,"c" :$ })"}, kValues));
+
+  // Keys the template does not read itself fall back to parsing.
+  KERO_CHECK(MatchesRendered(FrameTemplate{R"({"a\"b":$})"}, kValues));
+
+  const FrameTemplate no_slot{R"({"event":"heartbeat"})"};
+  KERO_CHECK(MatchesRendered(no_slot, {}));
+  KERO_CHECK(FrameTemplate{R"({"a":$)"}.ToFlatJson(kValues).IsErr());
+}
@@ -0,0 +1,113 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <source_location>
+#include <string>
+
+#include "kero/core/flat_json_parser.h"
+#include "kero/log/core.h"
+#include "kero/log/file_json_lines_transport.h"
+#include "kero/log/utils.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+constexpr std::chrono::system_clock::time_point kTimePoint{
+    std::chrono::seconds{1700000000} + std::chrono::microseconds{42}};
+
+[[nodiscard]] auto
+ReadFile(const std::string& path) -> std::string {
+  std::ifstream file{path};
+  return std::string{std::istreambuf_iterator<char>{file},
+                     std::istreambuf_iterator<char>{}};
+}
+
+}  // namespace
+
+KERO_TEST(AppendJsonEscapedEscapesQuotesAndControlCharacters) {
+  std::string out{"x"};
+  AppendJsonEscaped(out, "plain");
+  KERO_CHECK(out == "xplain");
+
+  out.clear();
+  AppendJsonEscaped(out, "a\"b\\c/d");
+  KERO_CHECK(out == R"(a\"b\\c\/d)");
+
+  out.clear();
+  AppendJsonEscaped(out, "\b\f\n\r\t");
+  KERO_CHECK(out == R"(\b\f\n\r\t)");
+
+  out.clear();
+  AppendJsonEscaped(out, std::string_view{"\x01-\x1f-\0", 5});
+  KERO_CHECK(out == R"(\u0001-\u001f-\u0000)");
+
+  // Bytes of UTF-8 are kept as they are.
+  out.clear();
+  AppendJsonEscaped(out, "\xea\xb0\x80");
+  KERO_CHECK(out == "\xea\xb0\x80");
+}
+
+KERO_TEST(AppendJsonLineWritesOneObjectPerLine) {
+  auto location = std::source_location::current();
+  Log log{"say \"hi\"\n", std::move(location), Level::kWarn, kTimePoint};
+  log.data.emplace("key", "va\\lue");
+  log.thread_ordinal = 7;
+
+  std::string buffer{};
+  Iso8601Cache timestamp_cache{};
+  AppendJsonLine(buffer, log, timestamp_cache);
+
+  std::string expected{
+      R"({"time":"2023-11-14T22:13:20.000042Z","level":")"};
+  expected += LevelToString(Level::kWarn);
+  expected += R"(","thread":7,"message":"say \"hi\"\n",)";
+  expected += R"("data":{"key":"va\\lue"},"location":")";
+  AppendJsonEscaped(expected, log.location.file_name());
+  expected += ':' + std::to_string(log.location.line()) + ':' +
+              std::to_string(log.location.column()) + R"(","function":")";
+  AppendJsonEscaped(expected, log.location.function_name());
+  expected += "\"}\n";
+  KERO_CHECK(buffer == expected);
+}
+
+KERO_TEST(FileJsonLinesTransportRotatesWithAsyncSync) {
+  char dir[] = "/tmp/kero_test_XXXXXX";
+  if (!KERO_CHECK(::mkdtemp(dir) != nullptr)) {
+    return;
+  }
+
+  const std::string path = std::string{dir} + "/log.jsonl";
+  {
+    auto transport = FileJsonLinesTransport::Builder{}.Build(
+        FileJsonLinesOptions{.path = path,
+                             .max_file_size = 1,
+                             .max_backup_count = 1,
+                             .use_async_sync = true});
+    if (!KERO_CHECK(transport.IsOk())) {
+      return;
+    }
+
+    // Each batch is over the size limit, so it rotates out the one before.
+    for (const auto* message : {"first", "second", "third"}) {
+      transport.Ok()->OnLog(Log{message, {}, Level::kInfo, kTimePoint});
+      transport.Ok()->OnFlush();
+    }
+  }
+
+  const auto current = ReadFile(path);
+  const auto backup = ReadFile(path + ".1");
+  KERO_CHECK(current.find("\"third\"") != std::string::npos &&
+             current.find('\n') == current.size() - 1);
+  KERO_CHECK(backup.find("\"second\"") != std::string::npos &&
+             backup.find('\n') == backup.size() - 1);
+  KERO_CHECK(::access((path + ".2").c_str(), F_OK) != 0);
+
+  ::unlink(path.c_str());
+  ::unlink((path + ".1").c_str());
+  ::rmdir(dir);
+}
@@ -0,0 +1,15 @@
+#include "kero/log/center.h"
+#include "kero_test/kero_test.h"
+
+/**
+ * Unit tests of the kero libraries. Each `*_test.cc` registers its tests with
+ * `KERO_TEST`; run with `ctest` or directly.
+ */
+auto
+main() -> int {
+  const auto exit_code = kero::test::RunAll();
+
+  // Code under test may log, which starts the log thread.
+  kero::Center{}.Shutdown();
+  return exit_code;
+}
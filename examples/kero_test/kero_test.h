@@ -0,0 +1,85 @@
+#ifndef KERO_TEST_KERO_TEST_H
+#define KERO_TEST_KERO_TEST_H
+
+#include <iostream>
+#include <source_location>
+#include <string_view>
+#include <vector>
+
+namespace kero::test {
+
+using TestFunction = void (*)();
+
+struct TestCase {
+  std::string_view name;
+  TestFunction function;
+};
+
+inline auto
+GetTestCases() noexcept -> std::vector<TestCase>& {
+  static std::vector<TestCase> test_cases{};
+  return test_cases;
+}
+
+inline auto
+GetFailureCount() noexcept -> size_t& {
+  static size_t failure_count{};
+  return failure_count;
+}
+
+inline auto
+Register(const std::string_view name, const TestFunction function) noexcept
+    -> bool {
+  GetTestCases().push_back(TestCase{.name = name, .function = function});
+  return true;
+}
+
+/**
+ * Reports a failed check and lets the test go on, so one run shows every
+ * failure.
+ */
+inline auto
+Check(const bool passed,
+      const std::string_view expression,
+      const std::source_location location =
+          std::source_location::current()) noexcept -> bool {
+  if (!passed) {
+    ++GetFailureCount();
+    std::cerr << location.file_name() << ":" << location.line()
+              << ": check failed: " << expression << "\n";
+  }
+
+  return passed;
+}
+
+/**
+ * Runs every registered test and returns the exit code of the program.
+ */
+inline auto
+RunAll() noexcept -> int {
+  for (const auto& test_case : GetTestCases()) {
+    const auto failure_count = GetFailureCount();
+    test_case.function();
+    std::cerr << (GetFailureCount() == failure_count ? "[  OK  ] "
+                                                     : "[ FAIL ] ")
+              << test_case.name << "\n";
+  }
+
+  return GetFailureCount() == 0 ? 0 : 1;
+}
+
+}  // namespace kero::test
+
+/**
+ * Defines a test function which `kero::test::RunAll` runs.
+ */
+#define KERO_TEST(name)                                 \
+  static auto name() -> void;                           \
+  [[maybe_unused]] static const bool name##_registered{ \
+      ::kero::test::Register(#name, name)};             \
+  static auto name() -> void
+
+#define KERO_CHECK(expression) \
+  ::kero::test::Check(static_cast<bool>(expression), #expression)
+
+#endif  // KERO_TEST_KERO_TEST_H
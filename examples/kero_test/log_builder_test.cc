@@ -0,0 +1,52 @@
+#include <memory>
+
+#include "kero/log/center.h"
+#include "kero/log/log_builder.h"
+#include "kero/log/transport.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+class NullTransport final : public Transport {
+ public:
+  explicit NullTransport(const Level level) noexcept : Transport{level} {}
+
+  virtual auto
+  OnLog([[maybe_unused]] const Log& log) noexcept -> void override {}
+};
+
+}  // namespace
+
+KERO_TEST(LogMacrosSkipArgumentsOfDisabledLevels) {
+  // The first transport sets the level, which is debug until then.
+  Center{}.AddTransport(std::make_unique<NullTransport>(Level::kInfo));
+  if (!KERO_CHECK(!log::IsLevelEnabled(Level::kDebug))) {
+    return;
+  }
+
+  u32 evaluated{};
+  const auto evaluate = [&evaluated] { return ++evaluated; };
+
+  // The builder drops the log, but its arguments are evaluated.
+  log::Debug("Builder").Data("n", evaluate()).Log();
+  KERO_CHECK(evaluated == 1);
+
+  KERO_LOG_DEBUG("Macro").Data("n", evaluate()).Log();
+  KERO_CHECK(evaluated == 1);
+
+  KERO_LOG_INFO("Macro").Data("n", evaluate()).Log();
+  KERO_CHECK(evaluated == 2);
+
+  // An `else` after the macro belongs to the `if` around it.
+  u32 else_count{};
+  const auto is_logged = false;
+  if (is_logged)
+    KERO_LOG_INFO("Macro").Data("n", evaluate()).Log();
+  else
+    ++else_count;
+
+  KERO_CHECK(else_count == 1);
+  KERO_CHECK(evaluated == 2);
+}
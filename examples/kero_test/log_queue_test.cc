@@ -0,0 +1,136 @@
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+
+#include "kero/log/log_queue.h"
+#include "kero/log/log_record.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+[[nodiscard]] auto
+MakeRecord(const Level level, const size_t index) -> Own<LogRecord> {
+  auto record = std::make_unique<LogRecord>();
+  record->level = level;
+  record->message = record->AppendText(std::to_string(index));
+  return record;
+}
+
+/**
+ * Returns the index of the popped record, or -1 when the queue is empty.
+ */
+[[nodiscard]] auto
+PopIndex(LogQueue& queue) -> i64 {
+  i64 index{-1};
+  std::ignore = queue.PopWith([&index](const LogRecord& record) noexcept {
+    index = std::stoll(std::string{record.GetText(record.message)});
+  });
+  return index;
+}
+
+}  // namespace
+
+KERO_TEST(LogQueueDropNewestKeepsTheQueuedRecords) {
+  auto queue = std::make_unique<LogQueue>(LogQueueOptions{});
+  for (size_t i = 0; i < LogQueue::kCapacity; ++i) {
+    KERO_CHECK(queue->Push(*MakeRecord(Level::kInfo, i)));
+  }
+
+  KERO_CHECK(!queue->Push(*MakeRecord(Level::kWarn, 1000)));
+  KERO_CHECK(!queue->Push(*MakeRecord(Level::kWarn, 1001)));
+  KERO_CHECK(!queue->Push(*MakeRecord(Level::kError, 1002)));
+
+  const auto counts = queue->GetDropCounts();
+  KERO_CHECK(counts[LevelToIndex(Level::kWarn)] == 2);
+  KERO_CHECK(counts[LevelToIndex(Level::kError)] == 1);
+  KERO_CHECK(counts[LevelToIndex(Level::kInfo)] == 0);
+  KERO_CHECK(PopIndex(*queue) == 0);
+
+  // A popped slot takes the next record.
+  KERO_CHECK(queue->Push(*MakeRecord(Level::kInfo, 2000)));
+  KERO_CHECK(!queue->Push(*MakeRecord(Level::kInfo, 2001)));
+  KERO_CHECK(queue->GetDropCounts()[LevelToIndex(Level::kInfo)] == 1);
+}
+
+KERO_TEST(LogQueueDropOldestCountsTheDiscardedRecords) {
+  auto queue = std::make_unique<LogQueue>(
+      LogQueueOptions{.overflow_policy = LogOverflowPolicy::kDropOldest});
+  for (size_t i = 0; i < LogQueue::kCapacity; ++i) {
+    const auto level = i < 2 ? Level::kDebug : Level::kInfo;
+    KERO_CHECK(queue->Push(*MakeRecord(level, i)));
+  }
+
+  for (size_t i = 0; i < 3; ++i) {
+    KERO_CHECK(queue->Push(*MakeRecord(Level::kError, 1000 + i)));
+  }
+
+  // The drops are counted under the levels of the discarded records.
+  const auto counts = queue->GetDropCounts();
+  KERO_CHECK(counts[LevelToIndex(Level::kDebug)] == 2);
+  KERO_CHECK(counts[LevelToIndex(Level::kInfo)] == 1);
+  KERO_CHECK(counts[LevelToIndex(Level::kError)] == 0);
+
+  KERO_CHECK(PopIndex(*queue) == 3);
+  i64 last{-1};
+  while (!queue->IsEmpty()) {
+    last = PopIndex(*queue);
+  }
+
+  KERO_CHECK(last == 1002);
+}
+
+KERO_TEST(LogQueueSampleKeepsOneInSampleRateOnceHalfFull) {
+  constexpr u32 kSampleRate{4};
+  auto queue = std::make_unique<LogQueue>(LogQueueOptions{
+      .overflow_policy = LogOverflowPolicy::kSample,
+      .sample_rate = kSampleRate});
+  constexpr size_t kHalf{LogQueue::kCapacity / 2};
+  for (size_t i = 0; i < kHalf; ++i) {
+    KERO_CHECK(queue->Push(*MakeRecord(Level::kInfo, i)));
+  }
+
+  size_t kept{};
+  constexpr size_t kSampledCount{kSampleRate * 16};
+  for (size_t i = 0; i < kSampledCount; ++i) {
+    kept += queue->Push(*MakeRecord(Level::kDebug, kHalf + i)) ? 1 : 0;
+  }
+
+  KERO_CHECK(kept == kSampledCount / kSampleRate);
+  KERO_CHECK(queue->GetDropCounts()[LevelToIndex(Level::kDebug)] ==
+             kSampledCount - kept);
+  KERO_CHECK(queue->GetDropCounts()[LevelToIndex(Level::kInfo)] == 0);
+}
+
+KERO_TEST(LogQueueBlockWaitsForRoom) {
+  auto queue = std::make_unique<LogQueue>(
+      LogQueueOptions{.overflow_policy = LogOverflowPolicy::kBlock});
+  constexpr size_t kCount{LogQueue::kCapacity * 4};
+
+  size_t in_order_count{};
+  std::thread consumer{[&queue, &in_order_count] {
+    for (size_t expected = 0; expected < kCount;) {
+      const auto index = PopIndex(*queue);
+      if (index < 0) {
+        std::this_thread::yield();
+        continue;
+      }
+
+      in_order_count += static_cast<size_t>(index) == expected ? 1 : 0;
+      ++expected;
+    }
+  }};
+
+  size_t pushed{};
+  for (size_t i = 0; i < kCount; ++i) {
+    pushed += queue->Push(*MakeRecord(Level::kInfo, i)) ? 1 : 0;
+  }
+
+  consumer.join();
+  KERO_CHECK(pushed == kCount);
+  KERO_CHECK(in_order_count == kCount);
+  KERO_CHECK(queue->GetDropCounts() == LogDropCounts{});
+}
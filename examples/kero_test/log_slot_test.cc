@@ -0,0 +1,103 @@
+#include <chrono>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "kero/log/global_context.h"
+#include "kero/log/local_context.h"
+#include "kero/log/log_queue.h"
+#include "kero/log/log_record.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+KERO_TEST(LogSlotsGiveEachLiveQueueItsOwnOrdinal) {
+  auto& global_context = GetGlobalContext();
+  const auto first = global_context.AddLogQueue(
+      std::make_shared<LogQueue>(LogQueueOptions{}));
+  const auto second = global_context.AddLogQueue(
+      std::make_shared<LogQueue>(LogQueueOptions{}));
+  if (!KERO_CHECK(first && second)) {
+    return;
+  }
+
+  KERO_CHECK(*first != *second);
+  KERO_CHECK(*first >= 1 && *first <= GlobalContext::kMaxLogThreadCount);
+  KERO_CHECK(*second >= 1 && *second <= GlobalContext::kMaxLogThreadCount);
+
+  KERO_CHECK(global_context.RemoveLogQueue(*first));
+  KERO_CHECK(!global_context.RemoveLogQueue(*first));
+  KERO_CHECK(global_context.RemoveLogQueue(*second));
+  KERO_CHECK(!global_context.RemoveLogQueue(0));
+  KERO_CHECK(!global_context.RemoveLogQueue(
+      static_cast<u16>(GlobalContext::kMaxLogThreadCount + 1)));
+}
+
+KERO_TEST(LogSlotIsReusedOnceItsQueueIsDrained) {
+  auto& global_context = GetGlobalContext();
+  auto log_queue = std::make_shared<LogQueue>(LogQueueOptions{});
+  const auto ordinal = global_context.AddLogQueue(log_queue);
+  if (!KERO_CHECK(ordinal.has_value())) {
+    return;
+  }
+
+  // The record left in the queue is drained before the slot is freed.
+  LogRecord record{};
+  record.level = Level::kDebug;
+  record.thread_ordinal = *ordinal;
+  record.message = record.AppendText("Left in an exited queue");
+  KERO_CHECK(log_queue->Push(record));
+  KERO_CHECK(global_context.RemoveLogQueue(*ordinal));
+
+  // The lowest free slot is taken first. Slots freed before it are held
+  // until it comes back.
+  std::vector<u16> held_ordinals{};
+  bool is_reused{false};
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds{5};
+  while (!is_reused && std::chrono::steady_clock::now() < deadline) {
+    const auto next = global_context.AddLogQueue(
+        std::make_shared<LogQueue>(LogQueueOptions{}));
+    if (!next) {
+      break;
+    }
+
+    held_ordinals.push_back(*next);
+    is_reused = *next == *ordinal;
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  for (const auto held_ordinal : held_ordinals) {
+    std::ignore = global_context.RemoveLogQueue(held_ordinal);
+  }
+
+  KERO_CHECK(is_reused);
+  KERO_CHECK(log_queue->IsEmpty());
+}
+
+KERO_TEST(LogSlotsGiveEachThreadItsOwnOrdinal) {
+  u16 first{};
+  u16 second{};
+  // Both threads are live at once, so neither can reuse the slot of the
+  // other.
+  std::latch both_live{2};
+  const auto get_ordinal = [&both_live](u16& ordinal) {
+    if (const auto& local_context = GetLocalContext()) {
+      ordinal = local_context->GetThreadOrdinal();
+    }
+
+    both_live.arrive_and_wait();
+  };
+
+  std::thread first_thread{get_ordinal, std::ref(first)};
+  std::thread second_thread{get_ordinal, std::ref(second)};
+  first_thread.join();
+  second_thread.join();
+
+  KERO_CHECK(first != 0 && second != 0);
+  KERO_CHECK(first != second);
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <source_location>
+
+#include "kero/log/rate_limiter.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+KERO_TEST(LogRateLimiterAllowsABurstThenRefills) {
+  using namespace std::chrono;
+
+  LogRateLimiter rate_limiter{};
+  const auto location = std::source_location::current();
+  const auto started_at = steady_clock::now();
+  const auto try_acquire = [&](const milliseconds elapsed) {
+    return rate_limiter.TryAcquire(location, started_at + elapsed, 10, 3);
+  };
+
+  for (u32 i = 0; i < 3; ++i) {
+    KERO_CHECK(try_acquire(milliseconds{0}).is_allowed);
+  }
+
+  KERO_CHECK(!try_acquire(milliseconds{0}).is_allowed);
+  KERO_CHECK(!try_acquire(milliseconds{50}).is_allowed);
+
+  // One token refills every 100 ms, and reports the logs suppressed before.
+  const auto refilled = try_acquire(milliseconds{100});
+  KERO_CHECK(refilled.is_allowed);
+  KERO_CHECK(refilled.suppressed_count == 2);
+  KERO_CHECK(!try_acquire(milliseconds{150}).is_allowed);
+
+  // A long pause refills only up to the burst.
+  const auto after_pause = try_acquire(seconds{10});
+  KERO_CHECK(after_pause.is_allowed);
+  KERO_CHECK(after_pause.suppressed_count == 1);
+  KERO_CHECK(try_acquire(seconds{10}).is_allowed);
+  KERO_CHECK(try_acquire(seconds{10}).is_allowed);
+  KERO_CHECK(!try_acquire(seconds{10}).is_allowed);
+}
+
+KERO_TEST(LogRateLimiterKeepsABucketPerCallSite) {
+  LogRateLimiter rate_limiter{};
+  const auto now = std::chrono::steady_clock::now();
+  const auto first = std::source_location::current();
+  const auto second = std::source_location::current();
+
+  KERO_CHECK(rate_limiter.TryAcquire(first, now, 1, 1).is_allowed);
+  KERO_CHECK(!rate_limiter.TryAcquire(first, now, 1, 1).is_allowed);
+  KERO_CHECK(!rate_limiter.TryAcquire(first, now, 1, 1).is_allowed);
+  KERO_CHECK(rate_limiter.TryAcquire(second, now, 1, 1).is_allowed);
+  KERO_CHECK(!rate_limiter.TryAcquire(second, now, 1, 1).is_allowed);
+
+  auto suppressed = rate_limiter.TakeSuppressed();
+  KERO_CHECK(suppressed.size() == 2);
+  u64 first_count{};
+  u64 second_count{};
+  for (const auto& [location, suppressed_count] : suppressed) {
+    (location.line() == first.line() ? first_count : second_count) +=
+        suppressed_count;
+  }
+
+  KERO_CHECK(first_count == 2);
+  KERO_CHECK(second_count == 1);
+
+  // Taking the counts resets them.
+  KERO_CHECK(rate_limiter.TakeSuppressed().empty());
+  const auto refilled =
+      rate_limiter.TryAcquire(first, now + std::chrono::seconds{1}, 1, 1);
+  KERO_CHECK(refilled.is_allowed);
+  KERO_CHECK(refilled.suppressed_count == 0);
+}
@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+
+#include "kero/core/frame_codec.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+/**
+ * Pops every complete frame and returns the event of each, or an empty
+ * string for a payload which does not decode.
+ */
+[[nodiscard]] auto
+PopEvents(SocketCodec& codec) -> std::vector<std::string> {
+  std::vector<std::string> events{};
+  std::string payload;
+  while (true) {
+    auto popped = codec.Pop(payload);
+    if (!KERO_CHECK(popped.IsOk()) || !popped.Ok()) {
+      return events;
+    }
+
+    auto decoded = codec.DecodePayload(payload);
+    if (decoded.IsErr()) {
+      events.emplace_back();
+      continue;
+    }
+
+    auto event = decoded.Ok().TryGet<std::string>("__event");
+    events.push_back(event ? event.Unwrap() : std::string{});
+  }
+}
+
+}  // namespace
+
+KERO_TEST(SocketCodecFramesAfterABadPayloadStillPop) {
+  SocketCodec codec{};
+  codec.Push(R"({"__event":"first"}{"__event":}{"__event":"third"})");
+  const auto events = PopEvents(codec);
+  KERO_CHECK(events.size() == 3);
+  KERO_CHECK(events.size() == 3 && events[0] == "first" && events[1].empty() &&
+             events[2] == "third");
+  KERO_CHECK(!codec.HasBuffered());
+}
+
+KERO_TEST(SocketCodecExportCarriesBufferedFrames) {
+  SocketCodec codec{};
+  codec.Push(R"({"__event":"first"}{"__event":"second"}{"__eve)");
+  auto exported = codec.Export();
+
+  auto imported_res = SocketCodec::Import(exported);
+  if (!KERO_CHECK(imported_res.IsOk())) {
+    return;
+  }
+
+  // Frames read by the previous owner arrive whole, the partial one is
+  // completed by the next read.
+  auto imported = imported_res.TakeOk();
+  KERO_CHECK(imported.HasBuffered());
+  imported.Push(R"(nt":"third"})");
+  const auto events = PopEvents(imported);
+  KERO_CHECK(events.size() == 3);
+  KERO_CHECK(events.size() == 3 && events[0] == "first" &&
+             events[1] == "second" && events[2] == "third");
+}
+
+KERO_TEST(SocketCodecDropsABrokenStream) {
+  SocketCodec codec{};
+  codec.Push(std::string{SocketCodec::kPrefaceMagic} +
+             static_cast<char>(FrameFormat::kLengthPrefixed) +
+             static_cast<char>(PayloadFormat::kFlatJsonText));
+
+  // A length header far over the limit, followed by more of the peer's
+  // bytes.
+  codec.Push(std::string{"\x7f\xff\xff\xff", 4});
+  codec.Push(std::string(4096, 'x'));
+  std::string payload;
+  auto popped = codec.Pop(payload);
+  KERO_CHECK(popped.IsErr());
+  KERO_CHECK(!codec.HasBuffered());
+}
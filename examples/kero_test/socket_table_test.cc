@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "kero/middleware/socket_table.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+KERO_TEST(SocketTableRejectsStaleHandle) {
+  SocketTable<std::string> table{};
+  const auto first = table.Insert(5, "first");
+  KERO_CHECK(first.IsSome());
+  KERO_CHECK(table.Insert(5, "again").IsNone());
+
+  const auto handle = first.Unwrap();
+  KERO_CHECK(table.Find(handle).IsSome());
+  KERO_CHECK(table.Erase(5));
+  KERO_CHECK(!table.Erase(5));
+  KERO_CHECK(table.Find(handle).IsNone());
+
+  // The kernel hands out the same fd again for the next socket.
+  const auto second = table.Insert(5, "second");
+  KERO_CHECK(second.IsSome());
+  KERO_CHECK(second.Unwrap().generation != handle.generation);
+  KERO_CHECK(table.Find(handle).IsNone());
+  KERO_CHECK(table.Find(second.Unwrap()).IsSome());
+  KERO_CHECK(table.Find(5).Unwrap() == "second");
+  KERO_CHECK(table.GetHandle(5).Unwrap() == second.Unwrap());
+}
+
+KERO_TEST(SocketTableKeepsLiveListDense) {
+  SocketTable<int> table{};
+  for (SocketId socket_id = 3; socket_id < 13; ++socket_id) {
+    KERO_CHECK(table.Insert(socket_id, static_cast<int>(socket_id)).IsSome());
+  }
+
+  KERO_CHECK(table.Erase(3));
+  KERO_CHECK(table.Erase(12));
+  KERO_CHECK(table.Erase(7));
+  KERO_CHECK(!table.Erase(100));
+  KERO_CHECK(table.Size() == 7);
+
+  std::vector<SocketId> live{table.GetLive().begin(), table.GetLive().end()};
+  std::sort(live.begin(), live.end());
+  KERO_CHECK((live == std::vector<SocketId>{4, 5, 6, 8, 9, 10, 11}));
+  for (const auto socket_id : live) {
+    KERO_CHECK(table.Contains(socket_id));
+    KERO_CHECK(table.Find(socket_id).Unwrap() == static_cast<int>(socket_id));
+  }
+
+  KERO_CHECK(!table.Contains(7));
+  KERO_CHECK(table.GetHandle(7).IsNone());
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <string>
+
+#include "kero/log/core.h"
+#include "kero/log/utils.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+constexpr std::chrono::system_clock::time_point kTimePoint{
+    std::chrono::seconds{1700000000} + std::chrono::microseconds{42}};
+
+}  // namespace
+
+KERO_TEST(TimePointToIso8601KeepsMicroseconds) {
+  KERO_CHECK(TimePointToIso8601(kTimePoint) ==
+             "2023-11-14T22:13:20.000042Z");
+  KERO_CHECK(TimePointToIso8601(std::chrono::system_clock::time_point{}) ==
+             "1970-01-01T00:00:00.000000Z");
+}
+
+KERO_TEST(Iso8601CacheMatchesTimePointToIso8601) {
+  using namespace std::chrono;
+
+  Iso8601Cache cache{};
+  // The same second twice, then the next second, which formats it again.
+  for (const auto time_point : {kTimePoint,
+                                kTimePoint + microseconds{999900},
+                                kTimePoint + seconds{1},
+                                kTimePoint + microseconds{123456}}) {
+    std::string out{"prefix "};
+    cache.Append(out, time_point);
+    KERO_CHECK(out == "prefix " + TimePointToIso8601(time_point));
+  }
+}
+
+KERO_TEST(SteadyToSystemTimeTracksTheWallClock) {
+  using namespace std::chrono;
+
+  const auto steady_now = steady_clock::now();
+  const auto system_now = system_clock::now();
+  const auto converted = SteadyToSystemTime(steady_now);
+  KERO_CHECK(converted - system_now < milliseconds{100} &&
+             system_now - converted < milliseconds{100});
+
+  // The offset is fixed, so steady intervals are kept.
+  KERO_CHECK(SteadyToSystemTime(steady_now + milliseconds{250}) - converted ==
+             milliseconds{250});
+}
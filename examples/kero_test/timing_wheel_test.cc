@@ -0,0 +1,118 @@
+#include <random>
+#include <vector>
+
+#include "kero/middleware/timing_wheel.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+KERO_TEST(TimingWheelFiresEachTimerOnItsTick) {
+  constexpr u32 kTimerCount{100000};
+  // Reaches into the last level, and starts off a level boundary, so timers
+  // cascade from every level.
+  constexpr u64 kMaxDelay{300000};
+
+  TimingWheel wheel{};
+  wheel.Reset(1000003);
+  std::mt19937_64 engine{32};
+  std::uniform_int_distribution<u64> delay{1, kMaxDelay};
+
+  std::vector<u64> expected_ticks(kTimerCount);
+  std::vector<u64> fired_ticks(kTimerCount);
+  std::vector<u32> fire_counts(kTimerCount);
+  std::vector<TimerId> timer_ids(kTimerCount);
+  for (u32 i = 0; i < kTimerCount; ++i) {
+    expected_ticks[i] = wheel.GetNowTick() + delay(engine);
+    timer_ids[i] = wheel.Schedule(
+        expected_ticks[i] - wheel.GetNowTick(),
+        [&wheel, &fired_ticks, &fire_counts, i] {
+          fired_ticks[i] = wheel.GetNowTick();
+          ++fire_counts[i];
+        });
+  }
+
+  KERO_CHECK(wheel.GetPendingCount() == kTimerCount);
+
+  // Every third timer is cancelled before it is due.
+  for (u32 i = 0; i < kTimerCount; i += 3) {
+    KERO_CHECK(wheel.Cancel(timer_ids[i]));
+    KERO_CHECK(!wheel.Cancel(timer_ids[i]));
+  }
+
+  for (u64 tick = 0; tick < kMaxDelay; ++tick) {
+    wheel.Advance(1);
+  }
+
+  KERO_CHECK(wheel.GetPendingCount() == 0);
+  u32 mismatch_count{};
+  for (u32 i = 0; i < kTimerCount; ++i) {
+    const auto is_cancelled = i % 3 == 0;
+    if (fire_counts[i] != (is_cancelled ? 0 : 1) ||
+        (!is_cancelled && fired_ticks[i] != expected_ticks[i])) {
+      ++mismatch_count;
+    }
+  }
+
+  KERO_CHECK(mismatch_count == 0);
+  KERO_CHECK(!wheel.Cancel(timer_ids[1]));
+}
+
+KERO_TEST(TimingWheelRunsEveryTimerOfALongAdvance) {
+  TimingWheel wheel{};
+  u32 fire_count{};
+  for (u64 delay = 100000; delay > 7; delay -= 7) {
+    (void)wheel.Schedule(delay, [&fire_count] { ++fire_count; });
+  }
+
+  const auto pending_count = wheel.GetPendingCount();
+  wheel.Advance(99999);
+  KERO_CHECK(fire_count == pending_count - 1);
+  wheel.Advance(1);
+  KERO_CHECK(fire_count == pending_count);
+}
+
+KERO_TEST(TimingWheelCallbacksMayScheduleAndCancel) {
+  TimingWheel wheel{};
+  u32 first_count{};
+  u32 second_count{};
+  u32 rescheduled_count{};
+  TimerId second{};
+
+  // Both are due on the same tick, whichever runs first cancels the other.
+  const auto first = wheel.Schedule(5, [&] {
+    ++first_count;
+    (void)wheel.Cancel(second);
+    (void)wheel.Schedule(5, [&rescheduled_count] { ++rescheduled_count; });
+  });
+  second = wheel.Schedule(5, [&] {
+    ++second_count;
+    (void)wheel.Cancel(first);
+  });
+
+  wheel.Advance(5);
+  KERO_CHECK(first_count + second_count == 1);
+  KERO_CHECK(wheel.GetPendingCount() == (first_count == 1 ? 1 : 0));
+
+  wheel.Advance(5);
+  KERO_CHECK(rescheduled_count == first_count);
+  KERO_CHECK(wheel.GetPendingCount() == 0);
+}
+
+KERO_TEST(TimingWheelClampsDelays) {
+  TimingWheel wheel{};
+  u32 zero_count{};
+  u32 far_count{};
+  (void)wheel.Schedule(0, [&zero_count] { ++zero_count; });
+  (void)wheel.Schedule(TimingWheel::kMaxDelayTicks * 2,
+                       [&far_count] { ++far_count; });
+
+  wheel.Advance(0);
+  KERO_CHECK(zero_count == 0);
+  wheel.Advance(1);
+  KERO_CHECK(zero_count == 1);
+
+  wheel.Advance(TimingWheel::kMaxDelayTicks - 2);
+  KERO_CHECK(far_count == 0);
+  wheel.Advance(1);
+  KERO_CHECK(far_count == 1);
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <source_location>
+#include <string>
+#include <vector>
+
+#include "kero/log/core.h"
+#include "kero/log/file_json_lines_transport.h"
+#include "kero/log/global_context.h"
+#include "kero/log/transport.h"
+
+using namespace kero;
+
+auto
+MakeLogs(const size_t count) -> std::vector<Own<Log>> {
+  std::vector<Own<Log>> logs{};
+  logs.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto log = std::make_unique<Log>(
+        "Battle resolved", std::source_location::current(), Level::kInfo);
+    log->data.emplace("battle_id", std::to_string(i));
+    log->data.emplace("round", std::to_string(i % 5 + 1));
+    log->data.emplace("result", "win");
+    logs.push_back(std::move(log));
+  }
+
+  return logs;
+}
+
+auto
+Measure(const char* name,
+        Transport& transport,
+        const std::vector<Own<Log>>& logs) -> void {
+  const auto started_at = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < logs.size(); ++i) {
+    transport.OnLog(*logs[i]);
+    if ((i + 1) % GlobalContext::kDrainBatchSize == 0) {
+      transport.OnFlush();
+    }
+  }
+
+  transport.OnFlush();
+  std::cout.flush();
+
+  const auto elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - started_at)
+                           .count();
+  std::cerr << name << ": " << logs.size() << " lines in " << elapsed
+            << " s, " << static_cast<u64>(logs.size() / elapsed)
+            << " lines/s\n";
+}
+
+/**
+ * Measures how many lines per second a transport writes, feeding it the
+ * same batches the log thread hands over. Logs are written to stdout, so
+ * redirect it, e.g. `log_benchmark 200000 > /dev/null`. With a path as the
+ * second argument, JSON lines are also written to that file.
+ */
+auto
+main(int argc, char** argv) -> int {
+  const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  const auto logs = MakeLogs(count);
+
+  ConsolePlainTextTransport console_transport{};
+  Measure("ConsolePlainTextTransport", console_transport, logs);
+
+  BufferedPlainTextTransport buffered_transport{};
+  Measure("BufferedPlainTextTransport", buffered_transport, logs);
+
+  if (argc > 2) {
+    auto file_res =
+        FileJsonLinesTransport::Builder{}.Build(FileJsonLinesOptions{
+            .path = argv[2], .max_backup_count = 1});
+    if (file_res.IsErr()) {
+      std::cerr << "Failed to open " << argv[2] << ": " << file_res.TakeErr()
+                << "\n";
+      return 1;
+    }
+
+    auto file_transport = file_res.TakeOk();
+    Measure("FileJsonLinesTransport", *file_transport, logs);
+  }
+
+  return 0;
+}
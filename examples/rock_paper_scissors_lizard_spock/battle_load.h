@@ -0,0 +1,127 @@
+#ifndef RPSLS_BATTLE_LOAD_H
+#define RPSLS_BATTLE_LOAD_H
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kero/core/common.h"
+
+/**
+ * Load of every battle runner, shared by all runners of the server.
+ *
+ * Each battle runner only writes its own entry, and match runners read the
+ * entries when placing a pair of players. Counters are relaxed atomics,
+ * placement needs a recent view rather than a consistent one.
+ */
+class BattleLoadTable final {
+ public:
+  using Index = kero::u32;
+
+  explicit BattleLoadTable(std::vector<std::string>&& names) noexcept
+      : names_{std::move(names)}, entries_(names_.size()) {}
+
+  ~BattleLoadTable() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(BattleLoadTable);
+
+  [[nodiscard]] auto
+  GetSize() const noexcept -> Index {
+    return static_cast<Index>(names_.size());
+  }
+
+  [[nodiscard]] auto
+  GetName(const Index index) const noexcept -> const std::string& {
+    return names_[index];
+  }
+
+  /**
+   * Sockets are counted from the moment a match runner places them, so
+   * several placements in a row see each other before the sockets arrive.
+   */
+  auto
+  AddSockets(const Index index, const kero::i64 delta) noexcept -> void {
+    entries_[index].socket_count.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  auto
+  AddBattles(const Index index, const kero::i64 delta) noexcept -> void {
+    entries_[index].battle_count.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  /**
+   * Folds one loop iteration of the runner into a moving average, so a
+   * runner stalled by slow sockets looks busier than its counts suggest.
+   */
+  auto
+  RecordTick(const Index index, const kero::u64 tick_us) noexcept -> void {
+    auto& tick_us_avg = entries_[index].tick_us_avg;
+    const auto prev = tick_us_avg.load(std::memory_order_relaxed);
+    tick_us_avg.store(prev - prev / kTickSmoothing + tick_us / kTickSmoothing,
+                      std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto
+  GetScore(const Index index) const noexcept -> kero::u64 {
+    const auto& entry = entries_[index];
+    const auto socket_count = std::max<kero::i64>(
+        entry.socket_count.load(std::memory_order_relaxed), 0);
+    const auto battle_count = std::max<kero::i64>(
+        entry.battle_count.load(std::memory_order_relaxed), 0);
+    return static_cast<kero::u64>(socket_count) +
+           static_cast<kero::u64>(battle_count) * kBattleWeight +
+           entry.tick_us_avg.load(std::memory_order_relaxed) /
+               kTickUsPerSocket;
+  }
+
+  /**
+   * Power of two choices: the less loaded of two random runners. Unlike
+   * always taking the minimum, match runners racing on stale counts do not
+   * all pile onto the same runner, and the cost stays constant in the
+   * number of runners.
+   */
+  template <typename Rng>
+  [[nodiscard]] auto
+  Pick(Rng& rng) const noexcept -> Index {
+    const auto size = GetSize();
+    if (size <= 2) {
+      return size == 2 && GetScore(1) < GetScore(0) ? 1 : 0;
+    }
+
+    std::uniform_int_distribution<Index> first_dist{0, size - 1};
+    std::uniform_int_distribution<Index> second_dist{0, size - 2};
+    const auto first = first_dist(rng);
+    auto second = second_dist(rng);
+    if (second >= first) {
+      ++second;
+    }
+
+    return GetScore(second) < GetScore(first) ? second : first;
+  }
+
+  /**
+   * A battle counts as two more sockets, it holds a round timer and both
+   * players are still acting.
+   */
+  static constexpr kero::u64 kBattleWeight{2};
+
+  /**
+   * Average loop time, in microseconds, which weighs as much as one socket.
+   */
+  static constexpr kero::u64 kTickUsPerSocket{50};
+
+  static constexpr kero::u64 kTickSmoothing{8};
+
+ private:
+  struct alignas(64) Entry {
+    std::atomic<kero::i64> socket_count{};
+    std::atomic<kero::i64> battle_count{};
+    std::atomic<kero::u64> tick_us_avg{};
+  };
+
+  std::vector<std::string> names_;
+  std::vector<Entry> entries_;
+};
+
+#endif  // RPSLS_BATTLE_LOAD_H
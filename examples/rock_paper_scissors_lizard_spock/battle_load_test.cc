@@ -0,0 +1,77 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "battle_load.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+namespace {
+
+[[nodiscard]] auto
+MakeLoadTable(const u32 size) -> BattleLoadTable {
+  std::vector<std::string> names{};
+  for (u32 i = 0; i < size; ++i) {
+    names.push_back("battle_" + std::to_string(i));
+  }
+
+  return BattleLoadTable{std::move(names)};
+}
+
+}  // namespace
+
+KERO_TEST(BattleLoadTableScoresBattlesAndTicks) {
+  auto load_table = MakeLoadTable(1);
+  KERO_CHECK(load_table.GetScore(0) == 0);
+
+  load_table.AddSockets(0, 3);
+  load_table.AddBattles(0, 1);
+  KERO_CHECK(load_table.GetScore(0) == 3 + BattleLoadTable::kBattleWeight);
+
+  load_table.AddBattles(0, -1);
+  load_table.AddSockets(0, -3);
+  KERO_CHECK(load_table.GetScore(0) == 0);
+
+  // A count briefly below zero, while a placement races a close, scores zero.
+  load_table.AddSockets(0, -1);
+  KERO_CHECK(load_table.GetScore(0) == 0);
+  load_table.AddSockets(0, 1);
+
+  for (u32 i = 0; i < 64; ++i) {
+    load_table.RecordTick(0, BattleLoadTable::kTickUsPerSocket * 80);
+  }
+
+  KERO_CHECK(load_table.GetScore(0) > 0);
+}
+
+KERO_TEST(BattleLoadTablePicksTheLessLoadedOfTwo) {
+  std::mt19937 rng{35};
+
+  auto single = MakeLoadTable(1);
+  single.AddSockets(0, 100);
+  KERO_CHECK(single.Pick(rng) == 0);
+
+  auto pair = MakeLoadTable(2);
+  KERO_CHECK(pair.Pick(rng) == 0);
+  pair.AddSockets(0, 1);
+  KERO_CHECK(pair.Pick(rng) == 1);
+
+  // Two random choices never land on the busiest runner, and spread over the
+  // others instead of always taking the minimum.
+  constexpr u32 kRunnerCount{4};
+  auto load_table = MakeLoadTable(kRunnerCount);
+  for (u32 i = 0; i < kRunnerCount; ++i) {
+    load_table.AddSockets(i, i);
+  }
+
+  std::vector<u32> pick_counts(kRunnerCount);
+  for (u32 i = 0; i < 1200; ++i) {
+    ++pick_counts[load_table.Pick(rng)];
+  }
+
+  KERO_CHECK(pick_counts[kRunnerCount - 1] == 0);
+  KERO_CHECK(pick_counts[0] > pick_counts[1]);
+  KERO_CHECK(pick_counts[1] > pick_counts[2]);
+  KERO_CHECK(pick_counts[2] > 0);
+}
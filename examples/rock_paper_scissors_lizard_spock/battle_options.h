@@ -0,0 +1,45 @@
+#ifndef RPSLS_BATTLE_OPTIONS_H
+#define RPSLS_BATTLE_OPTIONS_H
+
+#include <algorithm>
+
+#include "kero/core/common.h"
+#include "kero/core/flat_json.h"
+
+struct BattleOptions {
+  /**
+   * When a round is not resolved in time, a player who acted wins by forfeit,
+   * otherwise it is a draw. Zero lets a round wait forever.
+   */
+  kero::u64 round_timeout_ms{kDefaultRoundTimeoutMs};
+
+  /**
+   * A battle is a series which ends when a player has won more than half of
+   * `best_of` rounds. Players stay on the battle runner between rounds.
+   */
+  kero::u32 best_of{1};
+
+  [[nodiscard]] static auto
+  FromConfig(const kero::FlatJson& config) noexcept -> BattleOptions {
+    BattleOptions options{};
+    if (const auto round_timeout_ms =
+            config.TryGet<kero::u32>("round_timeout_ms")) {
+      options.round_timeout_ms = round_timeout_ms.Unwrap();
+    }
+
+    if (const auto best_of = config.TryGet<kero::u32>("best_of")) {
+      options.best_of = std::max(best_of.Unwrap(), kero::u32{1});
+    }
+
+    return options;
+  }
+
+  [[nodiscard]] auto
+  GetWinsNeeded() const noexcept -> kero::u32 {
+    return best_of / 2 + 1;
+  }
+
+  static constexpr kero::u64 kDefaultRoundTimeoutMs{30000};
+};
+
+#endif  // RPSLS_BATTLE_OPTIONS_H
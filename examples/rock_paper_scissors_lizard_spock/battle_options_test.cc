@@ -0,0 +1,35 @@
+#include "battle_options.h"
+#include "kero_test/kero_test.h"
+
+using namespace kero;
+
+KERO_TEST(BattleOptionsNeedMoreThanHalfTheRounds) {
+  const auto wins_needed = [](const u32 best_of) {
+    return BattleOptions{.best_of = best_of}.GetWinsNeeded();
+  };
+
+  KERO_CHECK(wins_needed(1) == 1);
+  KERO_CHECK(wins_needed(2) == 2);
+  KERO_CHECK(wins_needed(3) == 2);
+  KERO_CHECK(wins_needed(4) == 3);
+  KERO_CHECK(wins_needed(5) == 3);
+  KERO_CHECK(wins_needed(7) == 4);
+}
+
+KERO_TEST(BattleOptionsFromConfig) {
+  const auto defaults = BattleOptions::FromConfig(FlatJson{});
+  KERO_CHECK(defaults.round_timeout_ms ==
+             BattleOptions::kDefaultRoundTimeoutMs);
+  KERO_CHECK(defaults.best_of == 1);
+
+  const auto options = BattleOptions::FromConfig(
+      FlatJson{}.Set("round_timeout_ms", 0).Set("best_of", 5).Take());
+  KERO_CHECK(options.round_timeout_ms == 0);
+  KERO_CHECK(options.best_of == 5);
+  KERO_CHECK(options.GetWinsNeeded() == 3);
+
+  // A series has at least one round.
+  const auto zero =
+      BattleOptions::FromConfig(FlatJson{}.Set("best_of", 0).Take());
+  KERO_CHECK(zero.best_of == 1);
+}
@@ -1,6 +1,15 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <span>
+
+#include "battle_load.h"
+#include "battle_options.h"
 #include "common.h"
 #include "kero/core/flat_json.h"
 #include "kero/core/flat_json_parser.h"
+#include "kero/core/frame_template.h"
 #include "kero/core/utils.h"
 #include "kero/engine/actor_service.h"
 #include "kero/engine/common.h"
@@ -9,62 +18,75 @@
 #include "kero/middleware/common.h"
 #include "kero/middleware/io_event_loop_service.h"
 #include "kero/middleware/socket_pool_service.h"
+#include "kero/middleware/timer_service.h"
+#include "rpsls_resolver.h"
 
 using namespace kero;
 
-static const std::unordered_map<RpslsAction, std::vector<RpslsAction>> kWinMap{
-    {RpslsAction::kRock, {RpslsAction::kScissors, RpslsAction::kLizard}},
-    {RpslsAction::kPaper, {RpslsAction::kRock, RpslsAction::kSpock}},
-    {RpslsAction::kScissors, {RpslsAction::kPaper, RpslsAction::kLizard}},
-    {RpslsAction::kLizard, {RpslsAction::kSpock, RpslsAction::kPaper}},
-    {RpslsAction::kSpock, {RpslsAction::kScissors, RpslsAction::kRock}},
-};
-
-struct RpslsResultInfo {
-  RpslsResult player1;
-  RpslsResult player2;
-};
-
-auto
-GetResultInfo(const RpslsAction player1_action,
-              const RpslsAction player2_action) noexcept -> RpslsResultInfo {
-  if (player1_action == player2_action) {
-    return RpslsResultInfo{
-        .player1 = RpslsResult::kDraw,
-        .player2 = RpslsResult::kDraw,
-    };
-  }
-
-  const auto& wins = kWinMap.at(player1_action);
-  if (std::find(wins.begin(), wins.end(), player2_action) != wins.end()) {
-    return RpslsResultInfo{
-        .player1 = RpslsResult::kWin,
-        .player2 = RpslsResult::kLose,
-    };
-  }
-
-  return RpslsResultInfo{
-      .player1 = RpslsResult::kLose,
-      .player2 = RpslsResult::kWin,
-  };
-}
-
+/**
+ * The hot replies of a battle, rendered without building a `FlatJson`.
+ */
+static const FrameTemplate kBattleStartFrame{
+    R"({"event":"battle_start","battle_id":$,"opponent_socket_id":$})"};
+static const FrameTemplate kBattleResultFrame{
+    R"({"event":"battle_result","result":$,"round":$,"wins":$,"losses":$})"};
+static const FrameTemplate kRoundStartFrame{
+    R"({"event":"round_start","battle_id":$,"round":$})"};
+static const FrameTemplate kTimedOutBattleResultFrame{
+    R"({"event":"battle_result","result":$,"timed_out":true})"};
+
+/**
+ * Stored in the socket table slot of each player.
+ */
 struct PlayerState {
-  u64 battle_id{};
+  u64 battle_id{kNoBattle};
+
+  static constexpr u64 kNoBattle{0};
 };
 
 struct BattleState {
-  SocketId player1_socket_id{};
+  SocketHandle player1{};
   RpslsAction player1_action;
-  SocketId player2_socket_id{};
+  SocketHandle player2{};
   RpslsAction player2_action;
   u32 remaining_socket_count{};
+  TimerId round_timer{TimerService::kInvalidTimerId};
+
+  /**
+   * Rounds of the series are numbered from 1; draws are replayed and do not
+   * count towards `BattleOptions::best_of`.
+   */
+  u32 round{1};
+  u32 player1_wins{};
+  u32 player2_wins{};
+  bool is_over{false};
+
+  /**
+   * Time from the start of a round to its resolution.
+   */
+  std::chrono::steady_clock::time_point round_started_at{};
+  u64 total_round_latency_us{};
+  u64 max_round_latency_us{};
 };
 
-class BattleService final : public SocketPoolService<BattleService> {
+class BattleService final
+    : public SocketPoolService<BattleService, PlayerState> {
  public:
-  explicit BattleService(const Borrow<RunnerContext> runner_context) noexcept
-      : SocketPoolService{runner_context, {kServiceKindId_Actor}} {}
+  /**
+   * `load_index` is the entry of this runner in `load_table`, which the match
+   * runners read to place battles.
+   */
+  explicit BattleService(const Borrow<RunnerContext> runner_context,
+                         const Share<BattleLoadTable> load_table,
+                         const BattleLoadTable::Index load_index,
+                         const SocketPoolOptions pool_options = {},
+                         const BattleOptions battle_options = {}) noexcept
+      : SocketPoolService{runner_context,
+                          {kServiceKindId_Actor},
+                          pool_options},
+        load_table_{load_table},
+        load_index_{load_index},
+        battle_options_{battle_options} {}
 
   virtual ~BattleService() noexcept override = default;
   KERO_CLASS_KIND_MOVABLE(BattleService);
@@ -102,15 +124,6 @@ class BattleService final : public SocketPoolService<BattleService> {
       return ResultT::Err(res.TakeErr());
     }
 
-    const auto& name = GetDependency<ActorService>()->GetName();
-    GetDependency<ActorService>()->SendMail(
-        "match",
-        EventBattleSocketCount::kEvent,
-        FlatJson{}
-            .Set(EventBattleSocketCount::kName, name)
-            .Set(EventBattleSocketCount::kCount, socket_map_.size())
-            .Take());
-
     return OkVoid();
   }
 
@@ -119,21 +132,52 @@ class BattleService final : public SocketPoolService<BattleService> {
     SocketPoolService::OnDestroy();
   }
 
+  /**
+   * The runner loop never blocks, so the time between two updates is the
+   * work done by one iteration.
+   */
+  auto
+  OnUpdate() noexcept -> void override {
+    const auto now = std::chrono::steady_clock::now();
+    if (last_update_) {
+      load_table_->RecordTick(
+          load_index_,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              now - *last_update_)
+              .count());
+    }
+
+    last_update_ = now;
+    ResolveReadyBattles();
+  }
+
+  /**
+   * Battles in progress may finish their round, see `--shutdown-timeout`.
+   * A series ends with the round in progress once shutdown has started.
+   */
+  [[nodiscard]] auto
+  IsDrained() const noexcept -> bool override {
+    return ready_battle_ids_.empty() &&
+           std::none_of(battle_state_map_.begin(),
+                        battle_state_map_.end(),
+                        [](const auto& pair) {
+                          const auto& battle_state = pair.second;
+                          return !battle_state.is_over &&
+                                 (battle_state.player1_action ==
+                                      RpslsAction::kInvalid ||
+                                  battle_state.player2_action ==
+                                      RpslsAction::kInvalid);
+                        });
+  }
+
  private:
   [[nodiscard]] auto
   OnSocketMove(const FlatJson& data) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
 
-    auto socket_id_opt = data.TryGet<u64>(EventSocketMove::kSocketId);
-    if (!socket_id_opt) {
-      return ResultT::Err(
-          FlatJson{}
-              .Set("message", "Failed to get socket id from data")
-              .Take());
-    }
-
-    const auto socket_id = socket_id_opt.Unwrap();
-    if (auto res = RegisterBattleSocket(socket_id); res.IsErr()) {
+    if (auto res = ImportSocket(data); res.IsErr()) {
+      // The match runner counted the socket when placing it.
+      load_table_->AddSockets(load_index_, -1);
       return ResultT::Err(res.TakeErr());
     }
 
@@ -194,51 +238,57 @@ class BattleService final : public SocketPoolService<BattleService> {
     const auto player1_socket_id = player1_socket_id_opt.Unwrap();
     const auto player2_socket_id = player2_socket_id_opt.Unwrap();
 
-    battle_state_map_.emplace(battle_id,
-                              BattleState{
-                                  .player1_socket_id = player1_socket_id,
-                                  .player1_action = RpslsAction::kInvalid,
-                                  .player2_socket_id = player2_socket_id,
-                                  .player2_action = RpslsAction::kInvalid,
-                                  .remaining_socket_count = 2,
-                              });
-    player_state_map_.emplace(player1_socket_id,
-                              PlayerState{.battle_id = battle_id});
-    player_state_map_.emplace(player2_socket_id,
-                              PlayerState{.battle_id = battle_id});
-
-    auto player1_stringified_res = FlatJsonStringifier{}.Stringify(
-        FlatJson{}
-            .Set("event", "battle_start")
-            .Set("battle_id", battle_id)
-            .Set("opponent_socket_id", player2_socket_id)
-            .Take());
-    if (player1_stringified_res.IsErr()) {
-      return ResultT::Err(player1_stringified_res.TakeErr());
-    }
-
-    const auto player1_stringified = player1_stringified_res.TakeOk();
-    if (auto res =
-            GetDependency<IoEventLoopService>()->WriteToFd(player1_socket_id,
-                                                           player1_stringified);
+    const auto player1_opt = socket_table_.GetHandle(player1_socket_id);
+    const auto player2_opt = socket_table_.GetHandle(player2_socket_id);
+    if (!player1_opt || !player2_opt) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Battle player not registered")
+                              .Set("battle_id", battle_id)
+                              .Take());
+    }
+
+    if (IsShuttingDown()) {
+      WriteShutdown(player1_socket_id);
+      WriteShutdown(player2_socket_id);
+      return OkVoid();
+    }
+
+    battle_state_map_.emplace(
+        battle_id,
+        BattleState{
+            .player1 = player1_opt.Unwrap(),
+            .player1_action = RpslsAction::kInvalid,
+            .player2 = player2_opt.Unwrap(),
+            .player2_action = RpslsAction::kInvalid,
+            .remaining_socket_count = 2,
+            .round_timer = ScheduleRoundTimer(battle_id),
+            .round_started_at = std::chrono::steady_clock::now(),
+        });
+    load_table_->AddBattles(load_index_, 1);
+    GetUserData(player1_socket_id).Unwrap().battle_id = battle_id;
+    GetUserData(player2_socket_id).Unwrap().battle_id = battle_id;
+
+    if (auto res = WriteToSocket(player1_socket_id,
+                                 kBattleStartFrame,
+                                 {battle_id, player2_socket_id});
         res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
 
-    auto player2_stringified = FlatJsonStringifier{}.Stringify(
-        FlatJson{}
-            .Set("event", "battle_start")
-            .Set("battle_id", battle_id)
-            .Set("opponent_socket_id", player1_socket_id)
-            .Take());
-    if (player2_stringified.IsErr()) {
-      return ResultT::Err(player2_stringified.TakeErr());
+    if (auto res = WriteToSocket(player2_socket_id,
+                                 kBattleStartFrame,
+                                 {battle_id, player1_socket_id});
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
     }
 
-    if (auto res = GetDependency<IoEventLoopService>()->WriteToFd(
-            player2_socket_id,
-            player2_stringified.TakeOk());
-        res.IsErr()) {
+    // Frames read by the match runner but not handled there are handled now
+    // that the battle exists.
+    if (auto res = DispatchBufferedFrames(player1_socket_id); res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+
+    if (auto res = DispatchBufferedFrames(player2_socket_id); res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
 
@@ -272,134 +322,348 @@ class BattleService final : public SocketPoolService<BattleService> {
       return ResultT::Err(FlatJson{}.Set("message", "Invalid action").Take());
     }
 
-    const auto player_state_it = player_state_map_.find(socket_id);
-    if (player_state_it == player_state_map_.end()) {
+    const auto player_opt = socket_table_.GetHandle(socket_id);
+    if (!player_opt) {
       return ResultT::Err(
           FlatJson{}.Set("message", "Failed to find player state").Take());
     }
 
-    auto& player_state = player_state_it->second;
-    const auto battle_state_it = battle_state_map_.find(player_state.battle_id);
+    const auto player = player_opt.Unwrap();
+    const auto battle_id = GetUserData(player).Unwrap().battle_id;
+    if (battle_id == PlayerState::kNoBattle) {
+      return ResultT::Err(FlatJson{}.Set("message", "Not in a battle").Take());
+    }
+
+    const auto battle_state_it = battle_state_map_.find(battle_id);
     if (battle_state_it == battle_state_map_.end()) {
       return ResultT::Err(
           FlatJson{}.Set("message", "Failed to find battle state").Take());
     }
 
     auto& battle_state = battle_state_it->second;
-    if (battle_state.player1_socket_id == socket_id) {
-      battle_state.player1_action = rpsls_action;
-    } else if (battle_state.player2_socket_id == socket_id) {
-      battle_state.player2_action = rpsls_action;
+    if (battle_state.is_over) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Battle is over")
+                              .Set("battle_id", battle_id)
+                              .Take());
+    }
+
+    RpslsAction* player_action{};
+    if (battle_state.player1 == player) {
+      player_action = &battle_state.player1_action;
+    } else if (battle_state.player2 == player) {
+      player_action = &battle_state.player2_action;
     } else {
       return ResultT::Err(
           FlatJson{}.Set("message", "Failed to find player in battle").Take());
     }
 
+    // The round is queued once, when its second action arrives; a player can
+    // not act twice, nor change the action once made.
+    if (*player_action != RpslsAction::kInvalid) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Already acted in this round")
+                              .Set("battle_id", battle_id)
+                              .Set("round", battle_state.round)
+                              .Take());
+    }
+
+    *player_action = rpsls_action;
+
     // If both players have made their actions
     if (battle_state.player1_action == RpslsAction::kInvalid ||
         battle_state.player2_action == RpslsAction::kInvalid) {
       return OkVoid();
     }
 
-    const auto result_info =
-        GetResultInfo(battle_state.player1_action, battle_state.player2_action);
+    GetDependency<TimerService>()->Cancel(
+        std::exchange(battle_state.round_timer, TimerService::kInvalidTimerId));
+
+    // Resolved with the other rounds completed in this tick.
+    ready_battle_ids_.push_back(battle_id);
+    return OkVoid();
+  }
 
-    auto player1_stringified_res = FlatJsonStringifier{}.Stringify(
-        FlatJson{}
-            .Set("event", "battle_result")
-            .Set("result",
-                 static_cast<std::underlying_type_t<RpslsResult>>(
-                     result_info.player1))
-            .Take());
-    if (player1_stringified_res.IsErr()) {
-      return ResultT::Err(player1_stringified_res.TakeErr());
+  auto
+  ResolveReadyBattles() noexcept -> void {
+    if (ready_battle_ids_.empty()) {
+      return;
     }
 
-    const auto player1_stringified = player1_stringified_res.TakeOk();
-    if (auto res = GetDependency<IoEventLoopService>()->WriteToFd(
-            battle_state.player1_socket_id,
-            player1_stringified);
-        res.IsErr()) {
-      return ResultT::Err(res.TakeErr());
+    // A battle may have ended since its round completed.
+    std::erase_if(ready_battle_ids_, [this](const u64 battle_id) {
+      return !battle_state_map_.contains(battle_id);
+    });
+
+    ready_player1_actions_.clear();
+    ready_player2_actions_.clear();
+    for (const auto battle_id : ready_battle_ids_) {
+      const auto& battle_state = battle_state_map_.at(battle_id);
+      ready_player1_actions_.push_back(battle_state.player1_action);
+      ready_player2_actions_.push_back(battle_state.player2_action);
     }
 
-    auto player2_stringified_res = FlatJsonStringifier{}.Stringify(
-        FlatJson{}
-            .Set("event", "battle_result")
-            .Set("result",
-                 static_cast<std::underlying_type_t<RpslsResult>>(
-                     result_info.player2))
-            .Take());
-    if (player2_stringified_res.IsErr()) {
-      return ResultT::Err(player2_stringified_res.TakeErr());
+    ready_results_.resize(ready_battle_ids_.size());
+    ResolveRpslsRounds(
+        ready_player1_actions_, ready_player2_actions_, ready_results_);
+
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ready_battle_ids_.size(); ++i) {
+      const auto battle_id = ready_battle_ids_[i];
+      auto& battle_state = battle_state_map_.at(battle_id);
+      const auto& result_info = ready_results_[i];
+      RecordRoundLatency(battle_state, now);
+      if (result_info.player1 == RpslsResult::kWin) {
+        ++battle_state.player1_wins;
+      } else if (result_info.player2 == RpslsResult::kWin) {
+        ++battle_state.player2_wins;
+      }
+
+      WriteResolvedBattleResult(battle_state.player1,
+                                result_info.player1,
+                                battle_state.round,
+                                battle_state.player1_wins,
+                                battle_state.player2_wins);
+      WriteResolvedBattleResult(battle_state.player2,
+                                result_info.player2,
+                                battle_state.round,
+                                battle_state.player2_wins,
+                                battle_state.player1_wins);
+
+      const auto wins_needed = battle_options_.GetWinsNeeded();
+      if (battle_state.player1_wins >= wins_needed ||
+          battle_state.player2_wins >= wins_needed || IsShuttingDown()) {
+        EndSeries(battle_id, battle_state);
+      } else {
+        StartNextRound(battle_id, battle_state, now);
+      }
+    }
+
+    for (const auto battle_id : ready_battle_ids_) {
+      const auto battle_state_it = battle_state_map_.find(battle_id);
+      if (battle_state_it != battle_state_map_.end() &&
+          battle_state_it->second.is_over) {
+        battle_state_map_.erase(battle_state_it);
+      }
     }
 
-    const auto player2_stringified = player2_stringified_res.TakeOk();
-    if (auto res = GetDependency<IoEventLoopService>()->WriteToFd(
-            battle_state.player2_socket_id,
-            player2_stringified);
+    ready_battle_ids_.clear();
+  }
+
+  auto
+  WriteResolvedBattleResult(const SocketHandle player,
+                            const RpslsResult result,
+                            const u32 round,
+                            const u32 wins,
+                            const u32 losses) noexcept -> void {
+    if (auto res = WriteToSocket(
+            player,
+            kBattleResultFrame,
+            {static_cast<u64>(result), round, wins, losses});
         res.IsErr()) {
-      return ResultT::Err(res.TakeErr());
+      log::Error("Failed to send battle result")
+          .Data("socket_id", player.socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
     }
+  }
 
-    return OkVoid();
+  static auto
+  RecordRoundLatency(BattleState& battle_state,
+                     const std::chrono::steady_clock::time_point now) noexcept
+      -> void {
+    const auto latency_us = static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - battle_state.round_started_at)
+            .count());
+    battle_state.total_round_latency_us += latency_us;
+    battle_state.max_round_latency_us =
+        std::max(battle_state.max_round_latency_us, latency_us);
+  }
+
+  /**
+   * The players keep their sockets on this runner, they may disconnect or
+   * be matched again by reconnecting. The battle state is erased once the
+   * ready battles of the tick are resolved.
+   */
+  auto
+  EndSeries(const u64 battle_id, BattleState& battle_state) noexcept -> void {
+    battle_state.is_over = true;
+    load_table_->AddBattles(load_index_, -1);
+    for (const auto player : {battle_state.player1, battle_state.player2}) {
+      if (auto player_state = GetUserData(player)) {
+        player_state.Unwrap().battle_id = PlayerState::kNoBattle;
+      }
+    }
+
+    log::Debug("Battle series ended")
+        .Data("battle_id", battle_id)
+        .Data("round_count", battle_state.round)
+        .Data("player1_wins", battle_state.player1_wins)
+        .Data("player2_wins", battle_state.player2_wins)
+        .Data("avg_round_latency_us",
+              battle_state.total_round_latency_us / battle_state.round)
+        .Data("max_round_latency_us", battle_state.max_round_latency_us)
+        .Log();
+  }
+
+  auto
+  StartNextRound(const u64 battle_id,
+                 BattleState& battle_state,
+                 const std::chrono::steady_clock::time_point now) noexcept
+      -> void {
+    battle_state.player1_action = RpslsAction::kInvalid;
+    battle_state.player2_action = RpslsAction::kInvalid;
+    ++battle_state.round;
+    battle_state.round_started_at = now;
+    GetDependency<TimerService>()->Cancel(
+        std::exchange(battle_state.round_timer, TimerService::kInvalidTimerId));
+    battle_state.round_timer = ScheduleRoundTimer(battle_id);
+
+    for (const auto player : {battle_state.player1, battle_state.player2}) {
+      if (auto res = WriteToSocket(
+              player, kRoundStartFrame, {battle_id, battle_state.round});
+          res.IsErr()) {
+        log::Error("Failed to send round start")
+            .Data("socket_id", player.socket_id)
+            .Data("error", res.TakeErr())
+            .Log();
+      }
+    }
   }
 
   [[nodiscard]] auto
-  RegisterBattleSocket(const SocketId socket_id) noexcept -> Result<Void> {
-    using ResultT = Result<Void>;
+  ScheduleRoundTimer(const u64 battle_id) noexcept -> TimerId {
+    if (battle_options_.round_timeout_ms == 0) {
+      return TimerService::kInvalidTimerId;
+    }
 
-    if (auto res = RegisterSocket(socket_id); res.IsErr()) {
-      return ResultT::Err(res.TakeErr());
+    return GetDependency<TimerService>()->Schedule(
+        battle_options_.round_timeout_ms,
+        [this, battle_id] { OnRoundTimeout(battle_id); });
+  }
+
+  /**
+   * Ends the battle, so an absent or disconnected player can not keep the
+   * battle state and the socket of the opponent forever.
+   */
+  auto
+  OnRoundTimeout(const u64 battle_id) noexcept -> void {
+    const auto battle_state_it = battle_state_map_.find(battle_id);
+    if (battle_state_it == battle_state_map_.end()) {
+      return;
     }
 
-    const auto& name = GetDependency<ActorService>()->GetName();
-    GetDependency<ActorService>()->SendMail(
-        "match",
-        EventBattleSocketCount::kEvent,
-        FlatJson{}
-            .Set(EventBattleSocketCount::kName, name)
-            .Set(EventBattleSocketCount::kCount, socket_map_.size())
-            .Take());
+    const auto battle_state = battle_state_it->second;
+    battle_state_map_.erase(battle_state_it);
+    load_table_->AddBattles(load_index_, -1);
 
-    return OkVoid();
+    const auto player1_acted =
+        battle_state.player1_action != RpslsAction::kInvalid;
+    const auto player2_acted =
+        battle_state.player2_action != RpslsAction::kInvalid;
+    RpslsResultInfo result_info{
+        .player1 = RpslsResult::kDraw,
+        .player2 = RpslsResult::kDraw,
+    };
+    if (player1_acted && !player2_acted) {
+      result_info = {.player1 = RpslsResult::kWin,
+                     .player2 = RpslsResult::kLose};
+    } else if (!player1_acted && player2_acted) {
+      result_info = {.player1 = RpslsResult::kLose,
+                     .player2 = RpslsResult::kWin};
+    }
+
+    log::Info("Battle round timed out")
+        .Data("battle_id", battle_id)
+        .Data("player1_acted", player1_acted)
+        .Data("player2_acted", player2_acted)
+        .Log();
+
+    EndTimedOutPlayer(battle_state.player1, result_info.player1, player1_acted);
+    EndTimedOutPlayer(battle_state.player2, result_info.player2, player2_acted);
+  }
+
+  /**
+   * Players who never acted are disconnected; the socket close event then
+   * frees their slot as usual.
+   */
+  auto
+  EndTimedOutPlayer(const SocketHandle player,
+                    const RpslsResult result,
+                    const bool acted) noexcept -> void {
+    auto player_state = GetUserData(player);
+    if (!player_state) {
+      return;
+    }
+
+    player_state.Unwrap().battle_id = PlayerState::kNoBattle;
+    if (auto res = WriteToSocket(
+            player, kTimedOutBattleResultFrame, {static_cast<u64>(result)});
+        res.IsErr()) {
+      log::Warn("Failed to send timed out battle result")
+          .Data("socket_id", player.socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+
+    if (acted) {
+      return;
+    }
+
+    if (auto res = CloseSocket(player.socket_id); res.IsErr()) {
+      log::Error("Failed to close timed out player")
+          .Data("socket_id", player.socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
   }
 
   [[nodiscard]] auto
   UnregisterBattleSocket(const SocketId socket_id) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
 
+    // A close event may name a socket this runner never registered, such as
+    // one whose import failed and was counted off in `OnSocketMove`.
+    const auto player_state = GetUserData(socket_id);
+    if (!player_state) {
+      return UnregisterSocket(socket_id);
+    }
+
+    const auto battle_id = player_state.Unwrap().battle_id;
     if (auto res = UnregisterSocket(socket_id); res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
 
-    const auto player_state_it = player_state_map_.find(socket_id);
-    if (player_state_it != player_state_map_.end()) {
-      const auto battle_id = player_state_it->second.battle_id;
-      player_state_map_.erase(player_state_it);
-
+    load_table_->AddSockets(load_index_, -1);
+    if (battle_id != PlayerState::kNoBattle) {
       const auto battle_state_it = battle_state_map_.find(battle_id);
       if (battle_state_it != battle_state_map_.end()) {
         --battle_state_it->second.remaining_socket_count;
         if (battle_state_it->second.remaining_socket_count <= 0) {
+          GetDependency<TimerService>()->Cancel(
+              battle_state_it->second.round_timer);
           battle_state_map_.erase(battle_state_it);
+          load_table_->AddBattles(load_index_, -1);
           log::Debug("Battle ended").Data("battle_id", battle_id).Log();
         }
       }
     }
 
-    const auto& name = GetDependency<ActorService>()->GetName();
-    GetDependency<ActorService>()->SendMail(
-        "match",
-        EventBattleSocketCount::kEvent,
-        FlatJson{}
-            .Set(EventBattleSocketCount::kName, name)
-            .Set(EventBattleSocketCount::kCount, socket_map_.size())
-            .Take());
-
     return OkVoid();
   }
 
+  Share<BattleLoadTable> load_table_;
+  BattleLoadTable::Index load_index_{};
+  BattleOptions battle_options_{};
   std::unordered_map<u64 /* battle_id */, BattleState> battle_state_map_;
-  std::unordered_map<SocketId, PlayerState> player_state_map_;
+  std::optional<std::chrono::steady_clock::time_point> last_update_{};
+
+  /**
+   * Rounds completed since the last tick, and scratch for resolving them.
+   */
+  std::vector<u64> ready_battle_ids_;
+  std::vector<RpslsAction> ready_player1_actions_;
+  std::vector<RpslsAction> ready_player2_actions_;
+  std::vector<RpslsResultInfo> ready_results_;
 };
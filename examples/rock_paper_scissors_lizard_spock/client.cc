@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <type_traits>
@@ -15,9 +16,10 @@
 #include "kero/core/error.h"
 #include "kero/core/flat_json.h"
 #include "kero/core/flat_json_parser.h"
-#include "kero/core/flat_json_scanner.h"
+#include "kero/core/frame_codec.h"
 #include "kero/core/result.h"
 #include "kero/core/utils.h"
+#include "matchmaker.h"
 
 /**
  * `using namespace kero` is used because it is an example program.
@@ -31,6 +33,10 @@ enum Symbol : int32_t {
   kPortArgNotFound,
   kPortParsingFailed,
   kPortValueNotFound,
+  kFramingValueNotFound,
+  kFramingUnknown,
+  kRatingValueNotFound,
+  kRatingParsingFailed,
   kUnknownArgument,
 };
 
@@ -43,6 +49,8 @@ operator<<(std::ostream &os, const Symbol symbol) -> std::ostream & {
 struct Config final {
   std::string ip;
   u16 port{kUndefinedPort};
+  WireFormat wire_format{};
+  std::optional<Matchmaker::Rating> rating{};
 
   explicit Config() noexcept = default;
   ~Config() noexcept = default;
@@ -104,6 +112,52 @@ ParseArgs(int argc, char **argv) noexcept -> Result<Config> {
       continue;
     }
 
+    if (token == "--framing") {
+      const auto next = scanner.Next();
+      if (!next) {
+        return ResultT{Error::From(kFramingValueNotFound)};
+      }
+
+      const auto next_token = next.Unwrap();
+      if (next_token == "brace") {
+        config.wire_format = WireFormat{};
+      } else if (next_token == "length") {
+        config.wire_format = WireFormat{.frame = FrameFormat::kLengthPrefixed};
+      } else if (next_token == "binary") {
+        config.wire_format =
+            WireFormat{.frame = FrameFormat::kLengthPrefixed,
+                       .payload = PayloadFormat::kFlatJsonBinary};
+      } else {
+        return ResultT::Err(Error::From(
+            kFramingUnknown,
+            kero::FlatJson{}.Set("token", std::string{next_token}).Take()));
+      }
+
+      scanner.Eat();
+      scanner.Eat();
+      continue;
+    }
+
+    if (token == "--rating") {
+      const auto next = scanner.Next();
+      if (!next) {
+        return ResultT{Error::From(kRatingValueNotFound)};
+      }
+
+      const auto next_token = next.Unwrap();
+      auto result = kero::ParseNumberString<Matchmaker::Rating>(next_token);
+      if (result.IsErr()) {
+        return ResultT::Err(Error::From(
+            kRatingParsingFailed,
+            kero::FlatJson{}.Set("token", std::string{next_token}).Take()));
+      }
+
+      config.rating = result.Ok();
+      scanner.Eat();
+      scanner.Eat();
+      continue;
+    }
+
     return ResultT::Err(
         Error::From(kUnknownArgument,
                     kero::FlatJson{}.Set("token", std::string{token}).Take()));
@@ -126,7 +180,8 @@ main(int argc, char **argv) noexcept -> int {
   if (options_res.IsErr()) {
     const auto &error = options_res.Err();
     if (error.code == kHelpRequested) {
-      std::cout << "Usage: client [--ip <ip>] [--port <port>]";
+      std::cout << "Usage: client [--ip <ip>] [--port <port>] "
+                   "[--framing <brace|length|binary>] [--rating <rating>]";
     } else if (error.code == kIpArgNotFound) {
       std::cout << "Error: --ip argument not found";
     } else if (error.code == kIpValueNotFound) {
@@ -137,6 +192,14 @@ main(int argc, char **argv) noexcept -> int {
       std::cout << "Error: --port argument value not found";
     } else if (error.code == kPortParsingFailed) {
       std::cout << "Error: port parsing failed: " << error;
+    } else if (error.code == kFramingValueNotFound) {
+      std::cout << "Error: --framing argument value not found";
+    } else if (error.code == kFramingUnknown) {
+      std::cout << "Error: unknown framing: " << error;
+    } else if (error.code == kRatingValueNotFound) {
+      std::cout << "Error: --rating argument value not found";
+    } else if (error.code == kRatingParsingFailed) {
+      std::cout << "Error: rating parsing failed: " << error;
     } else if (error.code == kUnknownArgument) {
       std::cout << "Error: unknown argument";
     } else {
@@ -165,9 +228,19 @@ main(int argc, char **argv) noexcept -> int {
     return 1;
   }
 
+  SocketCodec codec;
+  if (options.wire_format.frame != FrameFormat::kBrace) {
+    const auto preface = codec.SwitchWriteFormat(options.wire_format);
+    if (send(sock, preface.data(), preface.size(), 0) == -1) {
+      std::cerr << "Failed to send the preface." << std::endl;
+      return 1;
+    }
+  }
+
   std::unordered_map<std::string, std::function<Result<Void>(const FlatJson &)>>
       event_handler_map;
-  event_handler_map["connect"] = [](const FlatJson &data) -> Result<Void> {
+  event_handler_map["connect"] =
+      [sock, &codec, &options](const FlatJson &data) -> Result<Void> {
     auto socket_id = data.TryGet<u64>("socket_id");
     if (!socket_id) {
       return Result<Void>::Err(
@@ -176,29 +249,53 @@ main(int argc, char **argv) noexcept -> int {
 
     std::cout << "Connected to the server with socket_id: "
               << socket_id.Unwrap() << std::endl;
+
+    if (!options.rating) {
+      return OkVoid();
+    }
+
+    auto frame_res =
+        codec.EncodeFrame(FlatJson{}
+                              .Set("__event", "match_rating")
+                              .Set("rating", *options.rating)
+                              .Take());
+    if (frame_res.IsErr()) {
+      return Result<Void>::Err(frame_res.TakeErr());
+    }
+
+    const auto frame = frame_res.TakeOk();
+    if (send(sock, frame.data(), frame.size(), 0) == -1) {
+      return Result<Void>::Err(
+          FlatJson{}.Set("message", "Failed to send the rating.").Take());
+    }
+
     return OkVoid();
   };
 
-  event_handler_map["battle_start"] =
-      [sock](const FlatJson &data) -> Result<Void> {
-    const auto battle_id = data.TryGet<u64>("battle_id");
-    if (!battle_id) {
-      return Result<Void>::Err(
-          FlatJson{}.Set("message", "Failed to get the battle id.").Take());
+  event_handler_map["heartbeat"] =
+      [sock, &codec]([[maybe_unused]] const FlatJson &data) -> Result<Void> {
+    auto frame_res =
+        codec.EncodeFrame(FlatJson{}.Set("__event", "heartbeat").Take());
+    if (frame_res.IsErr()) {
+      return Result<Void>::Err(frame_res.TakeErr());
     }
 
-    const auto opponent_socket_id = data.TryGet<u64>("opponent_socket_id");
-    if (!opponent_socket_id) {
+    const auto frame = frame_res.TakeOk();
+    if (send(sock, frame.data(), frame.size(), 0) == -1) {
       return Result<Void>::Err(
-          FlatJson{}
-              .Set("message", "Failed to get the opponent socket id.")
-              .Take());
+          FlatJson{}.Set("message", "Failed to answer the heartbeat.").Take());
     }
 
-    std::cout << "Battle started with battle id: " << battle_id.Unwrap()
-              << " and opponent socket id: " << opponent_socket_id.Unwrap()
-              << std::endl;
+    return OkVoid();
+  };
 
+  event_handler_map["shutdown"] =
+      []([[maybe_unused]] const FlatJson &data) -> Result<Void> {
+    std::cout << "The server is shutting down." << std::endl;
+    return OkVoid();
+  };
+
+  const auto play_round = [sock, &codec]() -> Result<Void> {
     RpslsAction action{RpslsAction::kInvalid};
     while (action == RpslsAction::kInvalid) {
       std::cout << "Please enter your action: ";
@@ -213,19 +310,19 @@ main(int argc, char **argv) noexcept -> int {
       }
     }
 
-    auto stringified_res = FlatJsonStringifier{}.Stringify(
+    auto frame_res = codec.EncodeFrame(
         FlatJson{}
             .Set("__event", "battle_action")
             .Set("action",
                  static_cast<std::underlying_type_t<RpslsAction>>(action))
             .Take());
-    if (stringified_res.IsErr()) {
+    if (frame_res.IsErr()) {
       return Result<Void>::Err(
-          FlatJson{}.Set("message", "Failed to stringify the action.").Take());
+          FlatJson{}.Set("message", "Failed to encode the action.").Take());
     }
 
-    const auto stringified = stringified_res.TakeOk();
-    auto count = send(sock, stringified.data(), stringified.size(), 0);
+    const auto frame = frame_res.TakeOk();
+    auto count = send(sock, frame.data(), frame.size(), 0);
     if (count == -1) {
       return Result<Void>::Err(
           FlatJson{}
@@ -238,6 +335,41 @@ main(int argc, char **argv) noexcept -> int {
     return OkVoid();
   };
 
+  event_handler_map["battle_start"] =
+      [&play_round](const FlatJson &data) -> Result<Void> {
+    const auto battle_id = data.TryGet<u64>("battle_id");
+    if (!battle_id) {
+      return Result<Void>::Err(
+          FlatJson{}.Set("message", "Failed to get the battle id.").Take());
+    }
+
+    const auto opponent_socket_id = data.TryGet<u64>("opponent_socket_id");
+    if (!opponent_socket_id) {
+      return Result<Void>::Err(
+          FlatJson{}
+              .Set("message", "Failed to get the opponent socket id.")
+              .Take());
+    }
+
+    std::cout << "Battle started with battle id: " << battle_id.Unwrap()
+              << " and opponent socket id: " << opponent_socket_id.Unwrap()
+              << std::endl;
+
+    return play_round();
+  };
+
+  event_handler_map["round_start"] =
+      [&play_round](const FlatJson &data) -> Result<Void> {
+    const auto round = data.TryGet<u64>("round");
+    if (!round) {
+      return Result<Void>::Err(
+          FlatJson{}.Set("message", "Failed to get the round.").Take());
+    }
+
+    std::cout << "Round " << round.Unwrap() << " started." << std::endl;
+    return play_round();
+  };
+
   event_handler_map["battle_result"] =
       [](const FlatJson &data) -> Result<Void> {
     const auto result_opt =
@@ -265,10 +397,17 @@ main(int argc, char **argv) noexcept -> int {
       std::cout << "The battle is a draw." << std::endl;
     }
 
+    const auto wins = data.TryGet<u64>("wins");
+    const auto losses = data.TryGet<u64>("losses");
+    if (wins && losses) {
+      std::cout << "Score: " << wins.Unwrap() << " - " << losses.Unwrap()
+                << std::endl;
+    }
+
     return OkVoid();
   };
 
-  FlatJsonScanner scanner;
+  std::string payload;
   while (true) {
     constexpr u64 kBufferSize{4096};
     char buffer[kBufferSize]{};
@@ -283,38 +422,45 @@ main(int argc, char **argv) noexcept -> int {
       break;
     }
 
-    std::cout << "[DEBUG] Server: " << buffer << " (" << read_size << "bytes)"
-              << std::endl;
+    std::cout << "[DEBUG] Server: " << read_size << " bytes" << std::endl;
 
-    scanner.Push(std::string_view{buffer, static_cast<size_t>(read_size)});
-    auto token_opt = scanner.Pop();
-    if (!token_opt) {
-      continue;
-    }
+    codec.Push(std::string_view{buffer, static_cast<size_t>(read_size)});
+    while (true) {
+      auto popped = codec.Pop(payload);
+      if (popped.IsErr()) {
+        std::cout << "Failed to decode the frame." << popped.Err()
+                  << std::endl;
+        return 1;
+      }
 
-    const auto &token = token_opt.Unwrap();
-    const auto message = kero::FlatJsonParser{}.Parse(token);
-    if (message.IsErr()) {
-      std::cout << "Failed to parse the message." << message.Err() << std::endl;
-      continue;
-    }
+      if (!popped.Ok()) {
+        break;
+      }
 
-    auto event_opt = message.Ok().TryGet<std::string>("event");
-    if (!event_opt) {
-      std::cout << "Failed to get the event of the message." << std::endl;
-      continue;
-    }
+      const auto message = codec.DecodePayload(payload);
+      if (message.IsErr()) {
+        std::cout << "Failed to parse the message." << message.Err()
+                  << std::endl;
+        continue;
+      }
 
-    const auto &event = event_opt.Unwrap();
+      auto event_opt = message.Ok().TryGet<std::string>("event");
+      if (!event_opt) {
+        std::cout << "Failed to get the event of the message." << std::endl;
+        continue;
+      }
 
-    auto found = event_handler_map.find(event);
-    if (found == event_handler_map.end()) {
-      std::cout << "Unknown event: " << event << std::endl;
-      continue;
-    }
+      const auto &event = event_opt.Unwrap();
+
+      auto found = event_handler_map.find(event);
+      if (found == event_handler_map.end()) {
+        std::cout << "Unknown event: " << event << std::endl;
+        continue;
+      }
 
-    if (auto res = found->second(message.Ok()); res.IsErr()) {
-      std::cout << "Failed to handle the event: " << res.Err() << std::endl;
+      if (auto res = found->second(message.Ok()); res.IsErr()) {
+        std::cout << "Failed to handle the event: " << res.Err() << std::endl;
+      }
     }
   }
 
@@ -13,10 +13,13 @@ enum : kero::ServiceKindId {
   kServiceKindId_RpslsEnd,
 };
 
-struct EventBattleSocketCount {
-  static constexpr auto kEvent = "battle_socket_count";
-  static constexpr auto kName = "name";
-  static constexpr auto kCount = "count";
+/**
+ * Sent by a player while waiting for an opponent, see `Matchmaker`.
+ */
+struct EventMatchRating {
+  static constexpr auto kEvent = "match_rating";
+  static constexpr auto kSocketId = "__socket_id";
+  static constexpr auto kRating = "rating";
 };
 
 struct EventBattleStart {
@@ -45,6 +48,13 @@ enum class RpslsAction : kero::i32 {
   kSpock,
 };
 
+/**
+ * Number of raw `RpslsAction` values, `RpslsAction::kInvalid` included.
+ */
+inline constexpr size_t kRpslsActionCount{6};
+static_assert(static_cast<size_t>(RpslsAction::kSpock) + 1 ==
+              kRpslsActionCount);
+
 inline auto
 StringToRpslsAction(const std::string& action) noexcept -> RpslsAction {
   if (action == "rock") {
@@ -1,6 +1,8 @@
-#include <unordered_map>
+#include <random>
 
+#include "battle_load.h"
 #include "common.h"
+#include "matchmaker.h"
 #include "kero/core/flat_json.h"
 #include "kero/core/flat_json_parser.h"
 #include "kero/core/utils.h"
@@ -10,13 +12,31 @@
 #include "kero/middleware/common.h"
 #include "kero/middleware/io_event_loop_service.h"
 #include "kero/middleware/socket_pool_service.h"
+#include "kero/middleware/timer_service.h"
 
 using namespace kero;
 
 class MatchService final : public SocketPoolService<MatchService> {
  public:
-  explicit MatchService(const Borrow<RunnerContext> runner_context) noexcept
-      : SocketPoolService{runner_context, {kServiceKindId_Actor}} {}
+  explicit MatchService(const Borrow<RunnerContext> runner_context,
+                        const Share<BattleLoadTable> load_table,
+                        const SocketPoolOptions options = {}) noexcept
+      : MatchService{runner_context, load_table, 0, 1, options} {}
+
+  /**
+   * With several match shards each shard hands out battle ids from its own
+   * residue class so ids stay unique across battle runners.
+   */
+  explicit MatchService(const Borrow<RunnerContext> runner_context,
+                        const Share<BattleLoadTable> load_table,
+                        const u32 shard_index,
+                        const u32 shard_count,
+                        const SocketPoolOptions options = {}) noexcept
+      : SocketPoolService{runner_context, {kServiceKindId_Actor}, options},
+        load_table_{load_table},
+        rng_{shard_index},
+        battle_id_{static_cast<u64>(shard_index) + 1},
+        battle_id_step_{shard_count > 0 ? shard_count : 1} {}
 
   virtual ~MatchService() noexcept override = default;
   KERO_CLASS_KIND_MOVABLE(MatchService);
@@ -36,15 +56,21 @@ class MatchService final : public SocketPoolService<MatchService> {
       return ResultT::Err(res.TakeErr());
     }
 
+    if (auto res =
+            RegisterMethodEventHandler(EventSocketOpenBatch::kEvent,
+                                       &MatchService::OnSocketOpenBatch);
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+
     if (auto res = RegisterMethodEventHandler(EventSocketClose::kEvent,
                                               &MatchService::OnSocketClose);
         res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
 
-    if (auto res =
-            RegisterMethodEventHandler(EventBattleSocketCount::kEvent,
-                                       &MatchService::OnBattleSocketCount);
+    if (auto res = RegisterMethodEventHandler(EventMatchRating::kEvent,
+                                              &MatchService::OnMatchRating);
         res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
@@ -52,91 +78,187 @@ class MatchService final : public SocketPoolService<MatchService> {
     return OkVoid();
   }
 
+  /**
+   * Waiting sockets are paired in batches, once per tick.
+   */
+  auto
+  OnUpdate() noexcept -> void override {
+    if (IsShuttingDown() || matchmaker_.GetWaitingCount() < 2 ||
+        load_table_->GetSize() == 0) {
+      return;
+    }
+
+    matchmaker_.Match(GetDependency<TimerService>()->GetNowMs(), match_pairs_);
+    for (const auto& pair : match_pairs_) {
+      if (auto res = StartBattle(pair); res.IsErr()) {
+        log::Error("Failed to start battle")
+            .Data("player1_socket_id", pair.player1)
+            .Data("player2_socket_id", pair.player2)
+            .Data("error", res.TakeErr())
+            .Log();
+      }
+    }
+
+    match_pairs_.clear();
+  }
+
  private:
   [[nodiscard]] auto
   OnSocketMove(const FlatJson& data) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
 
-    auto socket_id_opt = data.TryGet<u64>(EventSocketMove::kSocketId);
-    if (!socket_id_opt) {
-      return ResultT::Err(
-          FlatJson{}
-              .Set("message", "Failed to get socket id from data")
-              .Take());
+    auto socket_id_res = ImportSocket(data);
+    if (socket_id_res.IsErr()) {
+      return ResultT::Err(socket_id_res.TakeErr());
     }
 
-    const auto socket_id = socket_id_opt.Unwrap();
-    if (auto res = RegisterSocket(socket_id); res.IsErr()) {
-      return ResultT::Err(res.TakeErr());
+    const auto socket_id = socket_id_res.TakeOk();
+    if (auto res = AddWaitingSocket(socket_id); res.IsErr()) {
+      return res;
     }
 
-    auto stringified = FlatJsonStringifier{}.Stringify(
-        FlatJson{}.Set("event", "connect").Set("socket_id", socket_id).Take());
-    if (stringified.IsErr()) {
-      return ResultT::Err(stringified.TakeErr());
-    }
+    return DispatchBufferedFrames(socket_id);
+  }
 
-    if (auto res = GetDependency<IoEventLoopService>()->WriteToFd(
-            socket_id,
-            stringified.TakeOk());
-        res.IsErr()) {
-      return ResultT::Err(res.TakeErr());
+  /**
+   * Sockets accepted by a `TcpServerService` living on this runner (see
+   * `--match-shards`) are registered directly, without an actor hop.
+   */
+  [[nodiscard]] auto
+  OnSocketOpenBatch(const FlatJson& data) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    const auto count_opt = data.TryGet<u32>(EventSocketOpenBatch::kCount);
+    if (!count_opt) {
+      return ResultT::Err(
+          FlatJson{}.Set("message", "Failed to get count from data").Take());
     }
 
-    if (socket_map_.size() >= 2) {
-      const auto player1_it = socket_map_.begin();
-      const auto player1_socket_id = player1_it->first;
-      const auto player2_it = std::next(player1_it);
-      const auto player2_socket_id = player2_it->first;
-      if (auto res = UnregisterSocket(player1_socket_id); res.IsErr()) {
+    const auto count = count_opt.Unwrap();
+    for (u32 i = 0; i < count; ++i) {
+      const auto socket_id_opt = data.TryGet<u64>(
+          EventSocketOpenBatch::kSocketIdPrefix + std::to_string(i));
+      if (!socket_id_opt) {
+        return ResultT::Err(
+            FlatJson{}
+                .Set("message", "Failed to get socket id from data")
+                .Set("index", i)
+                .Take());
+      }
+
+      const auto socket_id = socket_id_opt.Unwrap();
+      if (auto res = RegisterSocket(socket_id); res.IsErr()) {
         return ResultT::Err(res.TakeErr());
       }
 
-      if (auto res = UnregisterSocket(player2_socket_id); res.IsErr()) {
+      if (auto res = AddWaitingSocket(socket_id); res.IsErr()) {
         return ResultT::Err(res.TakeErr());
       }
+    }
 
-      const auto min_battle_socket_count_it = std::min_element(
-          battle_socket_count_map_.begin(),
-          battle_socket_count_map_.end(),
-          [](const auto& a, const auto& b) { return a.second < b.second; });
-      if (min_battle_socket_count_it == battle_socket_count_map_.end()) {
-        return ResultT::Err(
+    return OkVoid();
+  }
+
+  [[nodiscard]] auto
+  AddWaitingSocket(const SocketId socket_id) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    // No new battles once shutting down; waiting sockets are closed when the
+    // runner is destroyed.
+    if (IsShuttingDown()) {
+      WriteShutdown(socket_id);
+      return OkVoid();
+    }
+
+    if (auto res = WriteToSocket(
+            socket_id,
             FlatJson{}
-                .Set("message", "Failed to get min battle socket count")
+                .Set("event", "connect")
+                .Set("socket_id", socket_id)
                 .Take());
-      }
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
 
-      const auto& name = min_battle_socket_count_it->first;
-      log::Debug("Matched players")
-          .Data("player1_socket_id", player1_socket_id)
-          .Data("player2_socket_id", player2_socket_id)
-          .Data("name", name)
-          .Log();
-
-      GetDependency<ActorService>()->SendMail(
-          std::string{name},
-          EventSocketMove::kEvent,
-          FlatJson{}.Set(EventSocketMove::kSocketId, player1_socket_id).Take());
-      GetDependency<ActorService>()->SendMail(
-          std::string{name},
-          EventSocketMove::kEvent,
-          FlatJson{}.Set(EventSocketMove::kSocketId, player2_socket_id).Take());
-
-      const auto battle_id = NextBattleId();
-      GetDependency<ActorService>()->SendMail(
-          std::string{name},
-          EventBattleStart::kEvent,
-          FlatJson{}
-              .Set(EventBattleStart::kBattleId, battle_id)
-              .Set(EventBattleStart::kPlayer1SocketId, player1_socket_id)
-              .Set(EventBattleStart::kPlayer2SocketId, player2_socket_id)
-              .Take());
+    matchmaker_.Enqueue(socket_id,
+                        Matchmaker::kDefaultRating,
+                        GetDependency<TimerService>()->GetNowMs());
+    return OkVoid();
+  }
+
+  [[nodiscard]] auto
+  StartBattle(const MatchPair& pair) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    const auto player1_socket_id = pair.player1;
+    const auto player2_socket_id = pair.player2;
+    auto player1_move_res = ExportSocket(player1_socket_id);
+    if (player1_move_res.IsErr()) {
+      return ResultT::Err(player1_move_res.TakeErr());
     }
 
+    auto player2_move_res = ExportSocket(player2_socket_id);
+    if (player2_move_res.IsErr()) {
+      RestoreWaitingSocket(player1_move_res.TakeOk(), pair.player1_rating);
+      return ResultT::Err(player2_move_res.TakeErr());
+    }
+
+    const auto load_index = load_table_->Pick(rng_);
+    load_table_->AddSockets(load_index, 2);
+
+    const auto& name = load_table_->GetName(load_index);
+    log::Debug("Matched players")
+        .Data("player1_socket_id", player1_socket_id)
+        .Data("player2_socket_id", player2_socket_id)
+        .Data("name", name)
+        .Log();
+
+    GetDependency<ActorService>()->SendMail(std::string{name},
+                                            EventSocketMove::kEvent,
+                                            player1_move_res.TakeOk());
+    GetDependency<ActorService>()->SendMail(std::string{name},
+                                            EventSocketMove::kEvent,
+                                            player2_move_res.TakeOk());
+
+    const auto battle_id = NextBattleId();
+    GetDependency<ActorService>()->SendMail(
+        std::string{name},
+        EventBattleStart::kEvent,
+        FlatJson{}
+            .Set(EventBattleStart::kBattleId, battle_id)
+            .Set(EventBattleStart::kPlayer1SocketId, player1_socket_id)
+            .Set(EventBattleStart::kPlayer2SocketId, player2_socket_id)
+            .Take());
+
     return OkVoid();
   }
 
+  /**
+   * Takes back a socket exported for a battle which could not start, at the
+   * back of the queue. A socket which can not be taken back is closed, no
+   * runner would ever see its close event otherwise.
+   */
+  auto
+  RestoreWaitingSocket(const FlatJson& move_data,
+                       const Matchmaker::Rating rating) noexcept -> void {
+    auto socket_id_res = ImportSocket(move_data);
+    if (socket_id_res.IsOk()) {
+      matchmaker_.Enqueue(socket_id_res.TakeOk(),
+                          rating,
+                          GetDependency<TimerService>()->GetNowMs());
+      return;
+    }
+
+    const auto socket_id = move_data.TryGet<u64>(EventSocketMove::kSocketId);
+    log::Error("Failed to restore waiting socket")
+        .Data("socket_id", socket_id ? socket_id.Unwrap() : 0)
+        .Data("error", socket_id_res.TakeErr())
+        .Log();
+    if (socket_id) {
+      (void)Fd::Close(static_cast<Fd::Value>(socket_id.Unwrap()));
+    }
+  }
+
   [[nodiscard]] auto
   OnSocketClose(const FlatJson& data) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
@@ -149,6 +271,7 @@ class MatchService final : public SocketPoolService<MatchService> {
               .Take());
     }
 
+    (void)matchmaker_.Remove(socket_id.Unwrap());
     if (auto res = UnregisterSocket(socket_id.Unwrap()); res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
@@ -156,40 +279,45 @@ class MatchService final : public SocketPoolService<MatchService> {
     return OkVoid();
   }
 
+  /**
+   * Ratings are supplied by the client; players who never send one wait with
+   * `Matchmaker::kDefaultRating`.
+   */
   [[nodiscard]] auto
-  OnBattleSocketCount(const FlatJson& data) noexcept -> Result<Void> {
+  OnMatchRating(const FlatJson& data) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
 
-    const auto name_opt =
-        data.TryGet<std::string>(EventBattleSocketCount::kName);
-    if (!name_opt) {
+    const auto socket_id = data.TryGet<u64>(EventMatchRating::kSocketId);
+    if (!socket_id) {
       return ResultT::Err(
-          FlatJson{}.Set("message", "Failed to get name from data").Take());
+          FlatJson{}
+              .Set("message", "Failed to get socket id from data")
+              .Take());
     }
 
-    const auto count_opt = data.TryGet<u64>(EventBattleSocketCount::kCount);
-    if (!count_opt) {
+    const auto rating =
+        data.TryGet<Matchmaker::Rating>(EventMatchRating::kRating);
+    if (!rating) {
       return ResultT::Err(
-          FlatJson{}.Set("message", "Failed to get count from data").Take());
+          FlatJson{}.Set("message", "Failed to get rating from data").Take());
     }
 
-    const auto name = name_opt.Unwrap();
-    const auto count = count_opt.Unwrap();
-    battle_socket_count_map_[name] = count;
-    log::Debug("Battle socket count updated")
-        .Data("name", name)
-        .Data("count", count)
-        .Log();
-
+    // Already paired, the rating only applies to the next wait.
+    (void)matchmaker_.SetRating(socket_id.Unwrap(), rating.Unwrap());
     return OkVoid();
   }
 
   auto
   NextBattleId() noexcept -> u64 {
-    return battle_id_++;
+    const auto battle_id = battle_id_;
+    battle_id_ += battle_id_step_;
+    return battle_id;
   }
 
+  Share<BattleLoadTable> load_table_;
+  std::minstd_rand rng_;
+  Matchmaker matchmaker_{};
+  std::vector<MatchPair> match_pairs_{};
   u64 battle_id_{1};
-  std::unordered_map<std::string /* name */, u64 /* count */>
-      battle_socket_count_map_{};
+  u64 battle_id_step_{1};
 };
@@ -0,0 +1,273 @@
+#ifndef RPSLS_MATCHMAKER_H
+#define RPSLS_MATCHMAKER_H
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+#include "kero/core/common.h"
+#include "kero/middleware/common.h"
+
+struct MatchPair {
+  kero::SocketId player1{};
+  kero::SocketId player2{};
+
+  /**
+   * Ratings the players waited with, so one can be put back in the queue.
+   */
+  kero::i32 player1_rating{};
+  kero::i32 player2_rating{};
+};
+
+struct MatchmakerOptions {
+  kero::i32 bucket_width{100};
+  kero::i32 initial_window{100};
+  kero::i32 window_per_second{50};
+  kero::i32 max_window{1000};
+  kero::u64 widen_interval_ms{100};
+  kero::u32 widen_scan_limit{256};
+};
+
+/**
+ * Pairs waiting players, oldest first, with the oldest opponent whose rating
+ * is inside their window. The window starts at `initial_window` and widens
+ * with the wait, so a player far from everyone else is matched eventually.
+ *
+ * Players are kept in buckets of `bucket_width` rating points and in one
+ * global queue, all ordered by arrival. Pairing a player only looks at the
+ * oldest few players of each bucket inside its window, so it costs
+ * O(window / bucket_width * log n) however many players wait.
+ *
+ * `Match` is meant to run once per tick. It pairs the players which arrived
+ * since the last tick, and every `widen_interval_ms` it also retries the
+ * oldest `widen_scan_limit` players with their wider windows.
+ */
+class Matchmaker final {
+ public:
+  using Rating = kero::i32;
+
+  explicit Matchmaker(const MatchmakerOptions options = {}) noexcept
+      : options_{options} {}
+
+  ~Matchmaker() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(Matchmaker);
+
+  /**
+   * A player already waiting keeps its place in the queue.
+   */
+  auto
+  Enqueue(const kero::SocketId socket_id,
+          const Rating rating,
+          const kero::u64 now_ms) noexcept -> void {
+    if (waiting_.contains(socket_id)) {
+      (void)SetRating(socket_id, rating);
+      return;
+    }
+
+    const auto seq = next_seq_++;
+    waiting_.emplace(
+        socket_id,
+        Waiting{.rating = rating, .enqueued_ms = now_ms, .seq = seq});
+    order_.emplace(seq, socket_id);
+    buckets_[GetBucket(rating)].emplace(seq, socket_id);
+    arrivals_.push_back(socket_id);
+  }
+
+  /**
+   * Moves a waiting player to the bucket of its new rating, without losing
+   * its place in the queue. Returns `false` when it is not waiting.
+   */
+  auto
+  SetRating(const kero::SocketId socket_id,
+            const Rating rating) noexcept -> bool {
+    const auto it = waiting_.find(socket_id);
+    if (it == waiting_.end()) {
+      return false;
+    }
+
+    auto& waiting = it->second;
+    EraseFromBucket(waiting);
+    waiting.rating = rating;
+    buckets_[GetBucket(rating)].emplace(waiting.seq, socket_id);
+    arrivals_.push_back(socket_id);
+    return true;
+  }
+
+  auto
+  Remove(const kero::SocketId socket_id) noexcept -> bool {
+    const auto it = waiting_.find(socket_id);
+    if (it == waiting_.end()) {
+      return false;
+    }
+
+    EraseFromBucket(it->second);
+    order_.erase(it->second.seq);
+    waiting_.erase(it);
+    return true;
+  }
+
+  /**
+   * Appends the pairs made in this tick to `pairs`, the player who waited
+   * longer first.
+   */
+  auto
+  Match(const kero::u64 now_ms, std::vector<MatchPair>& pairs) noexcept
+      -> void {
+    for (const auto socket_id : arrivals_) {
+      if (waiting_.contains(socket_id)) {
+        TryPair(socket_id, now_ms, pairs);
+      }
+    }
+
+    arrivals_.clear();
+
+    if (now_ms < next_widen_ms_) {
+      return;
+    }
+
+    next_widen_ms_ = now_ms + options_.widen_interval_ms;
+
+    // Pairing erases from the queue, so the oldest players are taken first.
+    for (const auto& [_, socket_id] : order_) {
+      if (scan_.size() >= options_.widen_scan_limit) {
+        break;
+      }
+
+      scan_.push_back(socket_id);
+    }
+
+    for (const auto socket_id : scan_) {
+      if (waiting_.contains(socket_id)) {
+        TryPair(socket_id, now_ms, pairs);
+      }
+    }
+
+    scan_.clear();
+  }
+
+  [[nodiscard]] auto
+  GetWaitingCount() const noexcept -> size_t {
+    return waiting_.size();
+  }
+
+  static constexpr Rating kDefaultRating{1500};
+
+ private:
+  struct Waiting {
+    Rating rating{};
+    kero::u64 enqueued_ms{};
+
+    /**
+     * Arrival order, unique for the lifetime of the matchmaker.
+     */
+    kero::u64 seq{};
+  };
+
+  using Queue = std::map<kero::u64 /* seq */, kero::SocketId>;
+
+  [[nodiscard]] auto
+  GetBucket(const kero::i64 rating) const noexcept -> kero::i64 {
+    const auto width = static_cast<kero::i64>(options_.bucket_width);
+    return rating >= 0 ? rating / width : -((-rating + width - 1) / width);
+  }
+
+  [[nodiscard]] auto
+  GetWindow(const kero::u64 wait_ms) const noexcept -> Rating {
+    const auto widened =
+        static_cast<kero::u64>(options_.initial_window) +
+        wait_ms * static_cast<kero::u64>(options_.window_per_second) / 1000;
+    return static_cast<Rating>(
+        std::min(widened, static_cast<kero::u64>(options_.max_window)));
+  }
+
+  auto
+  EraseFromBucket(const Waiting& waiting) noexcept -> void {
+    const auto it = buckets_.find(GetBucket(waiting.rating));
+    if (it == buckets_.end()) {
+      return;
+    }
+
+    it->second.erase(waiting.seq);
+    if (it->second.empty()) {
+      buckets_.erase(it);
+    }
+  }
+
+  auto
+  TryPair(const kero::SocketId socket_id,
+          const kero::u64 now_ms,
+          std::vector<MatchPair>& pairs) noexcept -> void {
+    const auto& self = waiting_.at(socket_id);
+    const auto window =
+        static_cast<kero::i64>(GetWindow(now_ms - self.enqueued_ms));
+    const auto low = static_cast<kero::i64>(self.rating) - window;
+    const auto high = static_cast<kero::i64>(self.rating) + window;
+
+    std::optional<std::pair<kero::u64 /* seq */, kero::SocketId>> best{};
+    const auto last = GetBucket(high);
+    for (auto it = buckets_.lower_bound(GetBucket(low));
+         it != buckets_.end() && it->first <= last;
+         ++it) {
+      // Buckets at the edge of the window may start with players just
+      // outside it, only a few are probed to keep the cost bounded.
+      size_t probed{};
+      for (const auto& [seq, candidate] : it->second) {
+        if (probed++ >= kProbeCount) {
+          break;
+        }
+
+        if (candidate == socket_id) {
+          continue;
+        }
+
+        const auto rating = waiting_.at(candidate).rating;
+        if (rating < low || rating > high) {
+          continue;
+        }
+
+        if (!best || seq < best->first) {
+          best.emplace(seq, candidate);
+        }
+
+        break;
+      }
+    }
+
+    if (!best) {
+      return;
+    }
+
+    const auto [opponent_seq, opponent] = *best;
+    const auto opponent_rating = waiting_.at(opponent).rating;
+    if (opponent_seq < self.seq) {
+      pairs.push_back(MatchPair{.player1 = opponent,
+                                .player2 = socket_id,
+                                .player1_rating = opponent_rating,
+                                .player2_rating = self.rating});
+    } else {
+      pairs.push_back(MatchPair{.player1 = socket_id,
+                                .player2 = opponent,
+                                .player1_rating = self.rating,
+                                .player2_rating = opponent_rating});
+    }
+
+    (void)Remove(opponent);
+    (void)Remove(socket_id);
+  }
+
+  static constexpr size_t kProbeCount{4};
+
+  MatchmakerOptions options_;
+  std::unordered_map<kero::SocketId, Waiting> waiting_;
+  std::map<kero::i64 /* bucket */, Queue> buckets_;
+  Queue order_;
+  std::vector<kero::SocketId> arrivals_;
+  std::vector<kero::SocketId> scan_;
+  kero::u64 next_seq_{1};
+  kero::u64 next_widen_ms_{};
+};
+
+#endif  // RPSLS_MATCHMAKER_H
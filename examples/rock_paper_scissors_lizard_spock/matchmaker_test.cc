@@ -0,0 +1,102 @@
+#include <vector>
+
+#include "kero_test/kero_test.h"
+#include "matchmaker.h"
+
+using namespace kero;
+
+KERO_TEST(MatchmakerPairsInArrivalOrder) {
+  Matchmaker matchmaker{};
+  for (SocketId socket_id = 1; socket_id <= 5; ++socket_id) {
+    matchmaker.Enqueue(socket_id, Matchmaker::kDefaultRating, 0);
+  }
+
+  std::vector<MatchPair> pairs{};
+  matchmaker.Match(0, pairs);
+  KERO_CHECK(pairs.size() == 2);
+  KERO_CHECK(pairs[0].player1 == 1 && pairs[0].player2 == 2);
+  KERO_CHECK(pairs[1].player1 == 3 && pairs[1].player2 == 4);
+  KERO_CHECK(matchmaker.GetWaitingCount() == 1);
+
+  // The player left over is paired first, the one who waited longer leads.
+  matchmaker.Enqueue(6, Matchmaker::kDefaultRating, 10);
+  pairs.clear();
+  matchmaker.Match(10, pairs);
+  KERO_CHECK(pairs.size() == 1);
+  KERO_CHECK(pairs[0].player1 == 5 && pairs[0].player2 == 6);
+  KERO_CHECK(matchmaker.GetWaitingCount() == 0);
+}
+
+KERO_TEST(MatchmakerPairsWithinRatingWindow) {
+  Matchmaker matchmaker{};
+  matchmaker.Enqueue(1, 1000, 0);
+  matchmaker.Enqueue(2, 2000, 0);
+  matchmaker.Enqueue(3, 1050, 0);
+  matchmaker.Enqueue(4, 2080, 0);
+  matchmaker.Enqueue(5, 1000 - 250, 0);
+
+  std::vector<MatchPair> pairs{};
+  matchmaker.Match(0, pairs);
+  KERO_CHECK(pairs.size() == 2);
+  KERO_CHECK(pairs[0].player1 == 1 && pairs[0].player2 == 3);
+  KERO_CHECK(pairs[0].player1_rating == 1000);
+  KERO_CHECK(pairs[0].player2_rating == 1050);
+  KERO_CHECK(pairs[1].player1 == 2 && pairs[1].player2 == 4);
+  KERO_CHECK(matchmaker.GetWaitingCount() == 1);
+}
+
+KERO_TEST(MatchmakerWidensWindowWithWait) {
+  const MatchmakerOptions options{};
+  Matchmaker matchmaker{options};
+  matchmaker.Enqueue(1, 1500, 0);
+  matchmaker.Enqueue(2, 1800, 0);
+
+  // 300 points apart, in reach once the window grew by 200.
+  const auto reach_ms = static_cast<u64>(300 - options.initial_window) * 1000 /
+                        static_cast<u64>(options.window_per_second);
+  std::vector<MatchPair> pairs{};
+  for (u64 now_ms = 0; now_ms < reach_ms; now_ms += options.widen_interval_ms) {
+    matchmaker.Match(now_ms, pairs);
+  }
+
+  KERO_CHECK(pairs.empty());
+  matchmaker.Match(reach_ms, pairs);
+  KERO_CHECK(pairs.size() == 1);
+  KERO_CHECK(pairs[0].player1 == 1 && pairs[0].player2 == 2);
+}
+
+KERO_TEST(MatchmakerKeepsPlaceOnRatingChange) {
+  Matchmaker matchmaker{};
+  matchmaker.Enqueue(1, 3000, 0);
+  matchmaker.Enqueue(2, 1500, 0);
+
+  std::vector<MatchPair> pairs{};
+  matchmaker.Match(0, pairs);
+  KERO_CHECK(pairs.empty());
+
+  KERO_CHECK(matchmaker.SetRating(1, 1520));
+  KERO_CHECK(!matchmaker.SetRating(3, 1500));
+  matchmaker.Enqueue(3, 1500, 1);
+  matchmaker.Match(1, pairs);
+  KERO_CHECK(pairs.size() == 1);
+  KERO_CHECK(pairs[0].player1 == 1 && pairs[0].player2 == 2);
+  KERO_CHECK(pairs[0].player1_rating == 1520);
+}
+
+KERO_TEST(MatchmakerForgetsRemovedPlayers) {
+  Matchmaker matchmaker{};
+  matchmaker.Enqueue(1, 1500, 0);
+  matchmaker.Enqueue(2, 1500, 0);
+  KERO_CHECK(matchmaker.Remove(1));
+  KERO_CHECK(!matchmaker.Remove(1));
+
+  std::vector<MatchPair> pairs{};
+  matchmaker.Match(0, pairs);
+  KERO_CHECK(pairs.empty());
+  KERO_CHECK(matchmaker.GetWaitingCount() == 1);
+
+  matchmaker.Enqueue(1, 1500, 5);
+  matchmaker.Match(5, pairs);
+  KERO_CHECK(pairs.size() == 1);
+  KERO_CHECK(pairs[0].player1 == 2 && pairs[0].player2 == 1);
+}
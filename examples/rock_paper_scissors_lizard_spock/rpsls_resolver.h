@@ -0,0 +1,132 @@
+#ifndef RPSLS_RPSLS_RESOLVER_H
+#define RPSLS_RPSLS_RESOLVER_H
+
+#include <algorithm>
+#include <array>
+#include <span>
+
+#include "common.h"
+
+struct RpslsResultInfo {
+  RpslsResult player1;
+  RpslsResult player2;
+};
+
+using RpslsResultTable =
+    std::array<std::array<RpslsResult, kRpslsActionCount>, kRpslsActionCount>;
+
+/**
+ * Result of the row action against the column action, indexed by raw
+ * actions. Built from the cycle documented on `RpslsAction`; rows and
+ * columns of `RpslsAction::kInvalid` hold `RpslsResult::kInvalid`.
+ */
+constexpr auto kRpslsResultTable = [] {
+  // Position of each raw action in the cycle.
+  constexpr std::array<kero::i32, kRpslsActionCount> kCycle{-1, 0, 4, 3, 1, 2};
+
+  RpslsResultTable table{};
+  for (size_t action = 1; action < kRpslsActionCount; ++action) {
+    for (size_t other = 1; other < kRpslsActionCount; ++other) {
+      const auto step = (kCycle[other] - kCycle[action] + 5) % 5;
+      table[action][other] = step == 0               ? RpslsResult::kDraw
+                             : step == 1 || step == 3 ? RpslsResult::kWin
+                                                      : RpslsResult::kLose;
+    }
+  }
+
+  return table;
+}();
+
+[[nodiscard]] constexpr auto
+LookupRpslsResult(const RpslsAction action,
+                  const RpslsAction other) noexcept -> RpslsResult {
+  return kRpslsResultTable[static_cast<size_t>(action)]
+                          [static_cast<size_t>(other)];
+}
+
+/**
+ * Every one of the 25 pairs: a draw against itself, otherwise a win one way
+ * and a loss the other, and two wins and two losses per action.
+ */
+[[nodiscard]] constexpr auto
+IsRpslsResultTableConsistent() noexcept -> bool {
+  for (size_t action = 1; action < kRpslsActionCount; ++action) {
+    kero::i32 win_count{};
+    kero::i32 lose_count{};
+    for (size_t other = 1; other < kRpslsActionCount; ++other) {
+      const auto result = kRpslsResultTable[action][other];
+      const auto reverse = kRpslsResultTable[other][action];
+      if (action == other) {
+        if (result != RpslsResult::kDraw) {
+          return false;
+        }
+
+        continue;
+      }
+
+      if (result == RpslsResult::kWin && reverse == RpslsResult::kLose) {
+        ++win_count;
+      } else if (result == RpslsResult::kLose && reverse == RpslsResult::kWin) {
+        ++lose_count;
+      } else {
+        return false;
+      }
+    }
+
+    if (win_count != 2 || lose_count != 2) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static_assert(IsRpslsResultTableConsistent());
+static_assert(LookupRpslsResult(RpslsAction::kScissors, RpslsAction::kPaper) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kPaper, RpslsAction::kRock) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kRock, RpslsAction::kLizard) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kLizard, RpslsAction::kSpock) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kSpock, RpslsAction::kScissors) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kScissors,
+                                RpslsAction::kLizard) == RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kLizard, RpslsAction::kPaper) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kPaper, RpslsAction::kSpock) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kSpock, RpslsAction::kRock) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kRock, RpslsAction::kScissors) ==
+              RpslsResult::kWin);
+static_assert(LookupRpslsResult(RpslsAction::kInvalid, RpslsAction::kRock) ==
+              RpslsResult::kInvalid);
+
+[[nodiscard]] constexpr auto
+GetResultInfo(const RpslsAction player1_action,
+              const RpslsAction player2_action) noexcept -> RpslsResultInfo {
+  return RpslsResultInfo{
+      .player1 = LookupRpslsResult(player1_action, player2_action),
+      .player2 = LookupRpslsResult(player2_action, player1_action),
+  };
+}
+
+/**
+ * Resolves a batch of rounds. The loop is branch free table lookups, so the
+ * compiler may unroll or vectorize it.
+ */
+inline auto
+ResolveRpslsRounds(const std::span<const RpslsAction> player1_actions,
+                   const std::span<const RpslsAction> player2_actions,
+                   const std::span<RpslsResultInfo> results) noexcept -> void {
+  const auto count = std::min(
+      {player1_actions.size(), player2_actions.size(), results.size()});
+  for (size_t i = 0; i < count; ++i) {
+    results[i] = GetResultInfo(player1_actions[i], player2_actions[i]);
+  }
+}
+
+#endif  // RPSLS_RPSLS_RESOLVER_H
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 #include "battle_service.cc"
 #include "kero/engine/actor_service.h"
@@ -12,6 +17,7 @@
 #include "kero/middleware/io_event_loop_service.h"
 #include "kero/middleware/socket_router_service.h"
 #include "kero/middleware/tcp_server_service.h"
+#include "kero/middleware/timer_service.h"
 #include "match_service.cc"
 
 /**
@@ -19,22 +25,88 @@
  */
 using namespace kero;
 
+enum : Error::Code {
+  kGameArgValueNotFound = 1,
+  kGameArgParsingFailed,
+};
+
+struct GameArg {
+  std::string_view flag;
+  std::string_view key;
+
+  /**
+   * A flag without a value sets its key to true.
+   */
+  bool takes_value{true};
+};
+
+/**
+ * Flags of the game, which `ConfigServiceFactory` does not know. Each takes a
+ * u32 value unless marked otherwise. A zero `--shutdown-timeout` closes every
+ * connection as soon as the shutdown event was sent, without waiting for
+ * battles. `--incoming-cpu` gives each match shard a `SO_INCOMING_CPU` hint.
+ */
+constexpr std::array kGameArgs{
+    GameArg{"--match-shards", "match_shards"},
+    GameArg{"--incoming-cpu", "incoming_cpu_hint", false},
+    GameArg{"--round-timeout", "round_timeout_ms"},
+    GameArg{"--shutdown-timeout", "shutdown_timeout_ms"},
+    GameArg{"--best-of", "best_of"},
+};
+
+/**
+ * The command line without the game flags, whose values every
+ * `ConfigServiceFactory` gets as overrides instead.
+ */
+struct ServerArgs final {
+  std::vector<char*> argv;
+  FlatJson overrides;
+
+  [[nodiscard]] auto
+  GetArgc() const noexcept -> int {
+    return static_cast<int>(argv.size());
+  }
+};
+
+auto
+ParseServerArgs(int argc, char** argv) -> Result<ServerArgs>;
 auto
 Run(int argc, char** argv) -> Result<Void>;
 auto
-BuildMainRunner(int argc,
-                char** argv,
-                const Share<Engine> engine) -> Result<Own<Runner>>;
+BuildMainRunner(ServerArgs& server_args,
+                const Share<Engine> engine,
+                const bool accept,
+                const u64 shutdown_timeout_ms) -> Result<Own<Runner>>;
+auto
+BuildMatchRunner(const Share<Engine> engine,
+                 const Share<BattleLoadTable> load_table,
+                 const SocketPoolOptions pool_options)
+    -> Result<Share<ThreadRunner>>;
 auto
-BuildMatchRunner(const Share<Engine> engine) -> Result<Share<ThreadRunner>>;
+BuildMatchShardRunner(ServerArgs& server_args,
+                      const Share<Engine> engine,
+                      const Share<BattleLoadTable> load_table,
+                      const u32 shard_index,
+                      const u32 shard_count,
+                      const bool incoming_cpu_hint,
+                      const SocketPoolOptions pool_options)
+    -> Result<Share<ThreadRunner>>;
 auto
 BuildBattleRunner(const Share<Engine> engine,
-                  const i32 index) -> Result<Share<ThreadRunner>>;
+                  const Share<BattleLoadTable> load_table,
+                  const BattleLoadTable::Index index,
+                  const SocketPoolOptions pool_options,
+                  const BattleOptions battle_options)
+    -> Result<Share<ThreadRunner>>;
 
 auto
 main(int argc, char** argv) -> int {
   Center{}.UseStreamForLoggingSystemError();
-  auto transport = std::make_unique<ConsolePlainTextTransport>();
+  if (auto res = Center{}.InstallCrashHandler(); res.IsErr()) {
+    std::cerr << "Failed to install crash handler: " << res.TakeErr() << "\n";
+  }
+
+  auto transport = std::make_unique<BufferedPlainTextTransport>();
   transport->SetLevel(Level::kDebug);
   Center{}.AddTransport(std::move(transport));
 
@@ -47,10 +119,86 @@ main(int argc, char** argv) -> int {
   return run_res.IsOk() ? 0 : 1;
 }
 
+auto
+ParseServerArgs(int argc, char** argv) -> Result<ServerArgs> {
+  using ResultT = Result<ServerArgs>;
+
+  ServerArgs server_args;
+  for (int i = 0; i < argc; ++i) {
+    const std::string_view token{argv[i]};
+    const auto game_arg =
+        std::find_if(kGameArgs.begin(),
+                     kGameArgs.end(),
+                     [token](const GameArg& arg) { return arg.flag == token; });
+    if (i == 0 || game_arg == kGameArgs.end()) {
+      server_args.argv.push_back(argv[i]);
+      continue;
+    }
+
+    if (!game_arg->takes_value) {
+      (void)server_args.overrides.Set(std::string{game_arg->key}, true);
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      return ResultT::Err(Error::From(
+          kGameArgValueNotFound,
+          FlatJson{}.Set("flag", std::string{token}).Take()));
+    }
+
+    const std::string value_str{argv[++i]};
+    auto res = ParseNumberString<u32>(value_str);
+    if (res.IsErr()) {
+      return ResultT::Err(Error::From(
+          kGameArgParsingFailed,
+          FlatJson{}.Set(std::string{game_arg->key}, value_str).Take(),
+          res.TakeErr()));
+    }
+
+    (void)server_args.overrides.Set(std::string{game_arg->key}, res.TakeOk());
+  }
+
+  return ResultT::Ok(std::move(server_args));
+}
+
 auto
 Run(int argc, char** argv) -> Result<Void> {
   using ResultT = Result<Void>;
 
+  auto server_args_res = ParseServerArgs(argc, argv);
+  if (server_args_res.IsErr()) {
+    return ResultT::Err(server_args_res.TakeErr());
+  }
+
+  auto server_args = server_args_res.TakeOk();
+  auto config_res = ConfigServiceFactory{server_args.GetArgc(),
+                                         server_args.argv.data(),
+                                         server_args.overrides.Clone()}
+                        .Parse();
+  if (config_res.IsErr()) {
+    return ResultT::Err(config_res.TakeErr());
+  }
+
+  const auto config = config_res.TakeOk();
+
+  // 0 keeps a single acceptor on the main runner which routes every socket to
+  // the "match" runner. N > 0 starts N match runners which each bind the port
+  // with SO_REUSEPORT, so sockets are born on the runner that matches them.
+  const auto match_shards_opt = config.TryGet<u32>("match_shards");
+  const auto match_shards =
+      match_shards_opt.IsSome() ? match_shards_opt.Unwrap() : 0;
+  const auto incoming_cpu_hint_opt = config.TryGet<bool>("incoming_cpu_hint");
+  const auto incoming_cpu_hint =
+      incoming_cpu_hint_opt.IsSome() && incoming_cpu_hint_opt.Unwrap();
+  const auto pool_options = SocketPoolOptions::FromConfig(config);
+  const auto battle_options = BattleOptions::FromConfig(config);
+  const auto shutdown_timeout_ms_opt =
+      config.TryGet<u32>("shutdown_timeout_ms");
+  const auto shutdown_timeout_ms =
+      shutdown_timeout_ms_opt.IsSome()
+          ? u64{shutdown_timeout_ms_opt.Unwrap()}
+          : SignalService::kDefaultShutdownTimeoutMs;
+
   StackDefer defer;
   auto engine = std::make_shared<Engine>();
   if (auto res = engine->Start(); res.IsErr()) {
@@ -63,31 +211,53 @@ Run(int argc, char** argv) -> Result<Void> {
     }
   });
 
-  auto match_runner_res = BuildMatchRunner(engine);
-  if (match_runner_res.IsErr()) {
-    return ResultT::Err(match_runner_res.TakeErr());
-  }
+  const auto core_count = std::thread::hardware_concurrency();
 
-  auto match_runner = match_runner_res.Ok();
-  if (auto res = match_runner->Start(); res.IsErr()) {
-    return ResultT::Err(res.TakeErr());
+  // minimum thread count is 3 (main io, logging, actor system).
+  const auto battle_count = core_count - 3 > 0 ? core_count : 1;
+
+  std::vector<std::string> battle_names;
+  for (u32 i = 0; i < battle_count; ++i) {
+    battle_names.emplace_back("battle:" + std::to_string(i));
   }
 
-  defer.Push([match_runner] {
-    if (auto res = match_runner->Stop(); res.IsErr()) {
-      log::Error("Failed to stop match runner")
-          .Data("error", res.TakeErr())
-          .Log();
+  // Battle runners publish their load here and match runners read it, so
+  // placement does not wait for a round trip through the actor system.
+  auto load_table = std::make_shared<BattleLoadTable>(std::move(battle_names));
+
+  const auto match_count = match_shards == 0 ? 1 : match_shards;
+  for (u32 i = 0; i < match_count; ++i) {
+    auto match_runner_res =
+        match_shards == 0
+            ? BuildMatchRunner(engine, load_table, pool_options)
+            : BuildMatchShardRunner(server_args,
+                                    engine,
+                                    load_table,
+                                    i,
+                                    match_shards,
+                                    incoming_cpu_hint,
+                                    pool_options);
+    if (match_runner_res.IsErr()) {
+      return ResultT::Err(match_runner_res.TakeErr());
     }
-  });
 
-  const auto core_count = std::thread::hardware_concurrency();
+    auto match_runner = match_runner_res.Ok();
+    if (auto res = match_runner->Start(); res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
 
-  // minimum thread count is 3 (main io, logging, actor system).
-  const auto battle_count = core_count - 3 > 0 ? core_count : 1;
+    defer.Push([match_runner] {
+      if (auto res = match_runner->Stop(); res.IsErr()) {
+        log::Error("Failed to stop match runner")
+            .Data("error", res.TakeErr())
+            .Log();
+      }
+    });
+  }
 
-  for (i32 i = 0; i < battle_count; ++i) {
-    auto battle_runner_res = BuildBattleRunner(engine, i);
+  for (BattleLoadTable::Index i = 0; i < load_table->GetSize(); ++i) {
+    auto battle_runner_res = BuildBattleRunner(
+        engine, load_table, i, pool_options, battle_options);
     if (battle_runner_res.IsErr()) {
       return ResultT::Err(battle_runner_res.TakeErr());
     }
@@ -106,40 +276,85 @@ Run(int argc, char** argv) -> Result<Void> {
     });
   }
 
-  auto main_runner_res = BuildMainRunner(argc, argv, engine);
+  auto main_runner_res = BuildMainRunner(
+      server_args, engine, match_shards == 0, shutdown_timeout_ms);
   if (main_runner_res.IsErr()) {
     return ResultT::Err(main_runner_res.TakeErr());
   }
 
   auto main_runner = main_runner_res.TakeOk();
+  // An interrupt is the normal way to stop the server. The deferred stops
+  // below then wait for the other runners, which drain on their own.
   if (auto res = main_runner->Run(); res.IsErr()) {
-    return ResultT::Err(res.TakeErr());
+    auto err = res.TakeErr();
+    if (err.code != kInterrupted) {
+      return ResultT::Err(std::move(err));
+    }
   }
 
   return OkVoid();
 }
 
 auto
-BuildMainRunner(int argc,
-                char** argv,
-                const Share<Engine> engine) -> Result<Own<Runner>> {
+BuildMainRunner(ServerArgs& server_args,
+                const Share<Engine> engine,
+                const bool accept,
+                const u64 shutdown_timeout_ms) -> Result<Own<Runner>> {
   using ResultT = Result<Own<Runner>>;
 
+  auto builder = engine->CreateRunnerBuilder("main");
+  (void)builder
+      .AddServiceFactory(std::make_unique<ConfigServiceFactory>(
+          server_args.GetArgc(),
+          server_args.argv.data(),
+          server_args.overrides.Clone()))
+      .AddServiceFactory(
+          [shutdown_timeout_ms](const Borrow<RunnerContext> runner_context) {
+            return Result<Own<Service>>{std::make_unique<SignalService>(
+                runner_context, shutdown_timeout_ms)};
+          })
+      .AddServiceFactory(std::make_unique<ActorServiceFactory>(engine));
+
+  if (accept) {
+    (void)builder
+        .AddServiceFactory(
+            std::make_unique<DefaultServiceFactory<IoEventLoopService>>())
+        .AddServiceFactory(
+            std::make_unique<DefaultServiceFactory<TcpServerService>>())
+        .AddServiceFactory([](const Borrow<RunnerContext> runner_context) {
+          return Result<Own<Service>>{
+              std::make_unique<SocketRouterService>(runner_context, "match")};
+        });
+  }
+
+  auto res = builder.BuildRunner();
+  if (res.IsErr()) {
+    return ResultT::Err(res.TakeErr());
+  }
+
+  return ResultT::Ok(res.TakeOk());
+}
+
+auto
+BuildMatchRunner(const Share<Engine> engine,
+                 const Share<BattleLoadTable> load_table,
+                 const SocketPoolOptions pool_options)
+    -> Result<Share<ThreadRunner>> {
+  using ResultT = Result<Share<ThreadRunner>>;
+
   auto res =
-      engine->CreateRunnerBuilder("main")
-          .AddServiceFactory(std::make_unique<ConfigServiceFactory>(argc, argv))
-          .AddServiceFactory(
-              std::make_unique<DefaultServiceFactory<SignalService>>())
+      engine->CreateRunnerBuilder("match")
           .AddServiceFactory(std::make_unique<ActorServiceFactory>(engine))
           .AddServiceFactory(
               std::make_unique<DefaultServiceFactory<IoEventLoopService>>())
           .AddServiceFactory(
-              std::make_unique<DefaultServiceFactory<TcpServerService>>())
-          .AddServiceFactory([](const Borrow<RunnerContext> runner_context) {
-            return Result<Own<Service>>{
-                std::make_unique<SocketRouterService>(runner_context, "match")};
+              std::make_unique<DefaultServiceFactory<TimerService>>())
+          .AddServiceFactory([load_table, pool_options](
+                                 const Borrow<RunnerContext> runner_context) {
+            return Result<Own<Service>>{std::make_unique<MatchService>(
+                runner_context, load_table, pool_options)};
           })
-          .BuildRunner();
+          .BuildThreadRunner();
 
   if (res.IsErr()) {
     return ResultT::Err(res.TakeErr());
@@ -149,16 +364,45 @@ BuildMainRunner(int argc,
 }
 
 auto
-BuildMatchRunner(const Share<Engine> engine) -> Result<Share<ThreadRunner>> {
+BuildMatchShardRunner(ServerArgs& server_args,
+                      const Share<Engine> engine,
+                      const Share<BattleLoadTable> load_table,
+                      const u32 shard_index,
+                      const u32 shard_count,
+                      const bool incoming_cpu_hint,
+                      const SocketPoolOptions pool_options)
+    -> Result<Share<ThreadRunner>> {
   using ResultT = Result<Share<ThreadRunner>>;
 
+  auto overrides = server_args.overrides.Clone();
+  (void)overrides.Set("reuse_port", true);
+  if (incoming_cpu_hint) {
+    (void)overrides.Set("incoming_cpu", static_cast<i32>(shard_index));
+  }
+
   auto res =
-      engine->CreateRunnerBuilder("match")
+      engine->CreateRunnerBuilder("match:" + std::to_string(shard_index))
+          .AddServiceFactory(
+              std::make_unique<ConfigServiceFactory>(server_args.GetArgc(),
+                                                     server_args.argv.data(),
+                                                     std::move(overrides)))
           .AddServiceFactory(std::make_unique<ActorServiceFactory>(engine))
           .AddServiceFactory(
               std::make_unique<DefaultServiceFactory<IoEventLoopService>>())
           .AddServiceFactory(
-              std::make_unique<DefaultServiceFactory<MatchService>>())
+              std::make_unique<DefaultServiceFactory<TimerService>>())
+          .AddServiceFactory(
+              std::make_unique<DefaultServiceFactory<TcpServerService>>())
+          .AddServiceFactory(
+              [load_table, shard_index, shard_count, pool_options](
+                  const Borrow<RunnerContext> runner_context) {
+                return Result<Own<Service>>{
+                    std::make_unique<MatchService>(runner_context,
+                                                   load_table,
+                                                   shard_index,
+                                                   shard_count,
+                                                   pool_options)};
+              })
           .BuildThreadRunner();
 
   if (res.IsErr()) {
@@ -170,16 +414,30 @@ BuildMatchRunner(const Share<Engine> engine) -> Result<Share<ThreadRunner>> {
 
 auto
 BuildBattleRunner(const Share<Engine> engine,
-                  const i32 index) -> Result<Share<ThreadRunner>> {
+                  const Share<BattleLoadTable> load_table,
+                  const BattleLoadTable::Index index,
+                  const SocketPoolOptions pool_options,
+                  const BattleOptions battle_options)
+    -> Result<Share<ThreadRunner>> {
   using ResultT = Result<Share<ThreadRunner>>;
 
   auto res =
-      engine->CreateRunnerBuilder("battle:" + std::to_string(index))
+      engine->CreateRunnerBuilder(std::string{load_table->GetName(index)})
           .AddServiceFactory(std::make_unique<ActorServiceFactory>(engine))
           .AddServiceFactory(
               std::make_unique<DefaultServiceFactory<IoEventLoopService>>())
           .AddServiceFactory(
-              std::make_unique<DefaultServiceFactory<BattleService>>())
+              std::make_unique<DefaultServiceFactory<TimerService>>())
+          .AddServiceFactory(
+              [load_table, index, pool_options, battle_options](
+                  const Borrow<RunnerContext> runner_context) {
+                return Result<Own<Service>>{std::make_unique<BattleService>(
+                    runner_context,
+                    load_table,
+                    index,
+                    pool_options,
+                    battle_options)};
+              })
           .BuildThreadRunner();
 
   if (res.IsErr()) {
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "rock_paper_scissors_lizard_spock/rpsls_resolver.h"
+
+using namespace kero;
+
+namespace {
+
+/**
+ * The resolver the table replaced: a map of the actions each action beats.
+ */
+const std::unordered_map<RpslsAction, std::vector<RpslsAction>> kWinMap{
+    {RpslsAction::kRock, {RpslsAction::kScissors, RpslsAction::kLizard}},
+    {RpslsAction::kPaper, {RpslsAction::kRock, RpslsAction::kSpock}},
+    {RpslsAction::kScissors, {RpslsAction::kPaper, RpslsAction::kLizard}},
+    {RpslsAction::kLizard, {RpslsAction::kSpock, RpslsAction::kPaper}},
+    {RpslsAction::kSpock, {RpslsAction::kScissors, RpslsAction::kRock}},
+};
+
+[[nodiscard]] auto
+GetResultInfoFromWinMap(const RpslsAction player1_action,
+                        const RpslsAction player2_action) -> RpslsResultInfo {
+  if (player1_action == player2_action) {
+    return RpslsResultInfo{
+        .player1 = RpslsResult::kDraw,
+        .player2 = RpslsResult::kDraw,
+    };
+  }
+
+  const auto& wins = kWinMap.at(player1_action);
+  if (std::find(wins.begin(), wins.end(), player2_action) != wins.end()) {
+    return RpslsResultInfo{
+        .player1 = RpslsResult::kWin,
+        .player2 = RpslsResult::kLose,
+    };
+  }
+
+  return RpslsResultInfo{
+      .player1 = RpslsResult::kLose,
+      .player2 = RpslsResult::kWin,
+  };
+}
+
+template <typename F>
+auto
+MeasureNs(const size_t count, const size_t batch_size, F&& f) -> double {
+  const auto started_at = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    f();
+  }
+
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - started_at)
+             .count() /
+         static_cast<double>(count * batch_size);
+}
+
+}  // namespace
+
+/**
+ * Time per resolved round of the win map and of the table, over batches of
+ * random actions the size of the ready rounds of one tick. The sum of the
+ * results keeps the work from being optimized away, and must match.
+ */
+auto
+main(int argc, char** argv) -> int {
+  const size_t batch_size =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+  const size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+
+  std::mt19937 engine{38};
+  std::uniform_int_distribution<i32> action{1, kRpslsActionCount - 1};
+  std::vector<RpslsAction> player1_actions(batch_size);
+  std::vector<RpslsAction> player2_actions(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    player1_actions[i] = static_cast<RpslsAction>(action(engine));
+    player2_actions[i] = static_cast<RpslsAction>(action(engine));
+  }
+
+  std::vector<RpslsResultInfo> results(batch_size);
+  u64 win_map_sum{};
+  const auto win_map_ns = MeasureNs(count, batch_size, [&] {
+    for (size_t i = 0; i < batch_size; ++i) {
+      results[i] =
+          GetResultInfoFromWinMap(player1_actions[i], player2_actions[i]);
+    }
+
+    for (const auto& result : results) {
+      win_map_sum += static_cast<u64>(result.player1);
+    }
+  });
+
+  u64 table_sum{};
+  const auto table_ns = MeasureNs(count, batch_size, [&] {
+    ResolveRpslsRounds(player1_actions, player2_actions, results);
+    for (const auto& result : results) {
+      table_sum += static_cast<u64>(result.player1);
+    }
+  });
+
+  std::cout << batch_size << " rounds per batch, " << count << " batches:\n"
+            << "  win map: " << win_map_ns << " ns/round\n"
+            << "  table:   " << table_ns << " ns/round ("
+            << win_map_ns / table_ns << "x)\n";
+  return win_map_sum == table_sum ? 0 : 1;
+}
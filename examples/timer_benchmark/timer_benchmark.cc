@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "kero/middleware/timer_service.h"
+#include "kero/middleware/timing_wheel.h"
+
+using namespace kero;
+
+template <typename F>
+auto
+MeasureNs(const size_t count, F&& f) -> double {
+  const auto started_at = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    f();
+  }
+
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - started_at)
+             .count() /
+         static_cast<double>(count);
+}
+
+/**
+ * Measures the wheel of `TimerService` with the timers of a busy runner: an
+ * idle timeout per socket, spread over 30 s, which is pushed back by every
+ * read. `timer_benchmark 100000` keeps 100k timers live.
+ */
+auto
+main(int argc, char** argv) -> int {
+  const size_t timer_count =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  constexpr u64 kIdleTicks{30000 / TimerService::kTickMs};
+
+  TimingWheel wheel{};
+  std::mt19937_64 engine{1};
+  std::uniform_int_distribution<u64> jitter{0, kIdleTicks};
+  u64 fire_count{};
+  const auto on_fire = [&fire_count] { ++fire_count; };
+
+  std::vector<TimerId> timer_ids(timer_count);
+  size_t next{};
+  const auto schedule_ns = MeasureNs(timer_count, [&] {
+    timer_ids[next++] = wheel.Schedule(kIdleTicks + jitter(engine), on_fire);
+  });
+
+  // A read cancels the idle timer of its socket and schedules it again.
+  std::uniform_int_distribution<size_t> socket{0, timer_count - 1};
+  const auto reset_ns = MeasureNs(1000000, [&] {
+    auto& timer_id = timer_ids[socket(engine)];
+    (void)wheel.Cancel(timer_id);
+    timer_id = wheel.Schedule(kIdleTicks, on_fire);
+  });
+
+  // Nothing is due yet, so this is the cost of a tick itself.
+  const auto idle_tick_ns =
+      MeasureNs(kIdleTicks / 2, [&wheel] { wheel.Advance(1); });
+
+  const auto pending_count = wheel.GetPendingCount();
+  const auto started_at = std::chrono::steady_clock::now();
+  while (wheel.GetPendingCount() > 0) {
+    wheel.Advance(1);
+  }
+
+  const auto fire_ns = std::chrono::duration<double, std::nano>(
+                           std::chrono::steady_clock::now() - started_at)
+                           .count() /
+                       static_cast<double>(pending_count);
+
+  std::cout << timer_count << " timers, tick " << TimerService::kTickMs
+            << " ms:\n"
+            << "  schedule:          " << schedule_ns << " ns\n"
+            << "  cancel+reschedule: " << reset_ns << " ns\n"
+            << "  tick, none due:    " << idle_tick_ns << " ns ("
+            << pending_count << " pending)\n"
+            << "  fire, per timer:   " << fire_ns << " ns\n";
+  return fire_count == pending_count ? 0 : 1;
+}
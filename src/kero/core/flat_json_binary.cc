@@ -0,0 +1,240 @@
+#include "flat_json_binary.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace kero;
+
+namespace {
+
+static auto
+WriteVarint(u64 value, std::string& output) noexcept -> void {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+
+  output.push_back(static_cast<char>(value));
+}
+
+[[nodiscard]] static auto
+ReadVarint(const std::string_view input, size_t& pos) noexcept -> Result<u64> {
+  using ResultT = Result<u64>;
+
+  u64 value{};
+  for (u32 shift = 0; shift < 64; shift += 7) {
+    if (pos >= input.size()) {
+      return ResultT::Err(Error::From(FlatJsonBinary::kUnexpectedEnd));
+    }
+
+    const auto byte = static_cast<u8>(input[pos++]);
+    value |= static_cast<u64>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return ResultT::Ok(std::move(value));
+    }
+  }
+
+  return ResultT::Err(Error::From(FlatJsonBinary::kVarintOverflow));
+}
+
+[[nodiscard]] static auto
+ReadString(const std::string_view input,
+           size_t& pos) noexcept -> Result<std::string> {
+  using ResultT = Result<std::string>;
+
+  auto size_res = ReadVarint(input, pos);
+  if (size_res.IsErr()) {
+    return ResultT::Err(size_res.TakeErr());
+  }
+
+  const auto size = size_res.TakeOk();
+  if (size > input.size() - pos) {
+    return ResultT::Err(Error::From(FlatJsonBinary::kUnexpectedEnd));
+  }
+
+  std::string str{input.substr(pos, size)};
+  pos += size;
+  return ResultT::Ok(std::move(str));
+}
+
+[[nodiscard]] static auto
+ZigZagEncode(const i64 value) noexcept -> u64 {
+  return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+}
+
+[[nodiscard]] static auto
+ZigZagDecode(const u64 value) noexcept -> i64 {
+  return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+}
+
+}  // namespace
+
+kero::FlatJsonBinaryEncoder::FlatJsonBinaryEncoder(
+    std::vector<std::string>&& keys) noexcept
+    : keys_{std::move(keys)} {
+  for (u32 i = 0; i < keys_.size(); ++i) {
+    key_indices_.emplace(keys_[i], i);
+  }
+}
+
+auto
+kero::FlatJsonBinaryEncoder::Encode(const FlatJson& json,
+                                    std::string& output) noexcept -> void {
+  WriteVarint(json.AsRaw().size(), output);
+  for (const auto& [key, value] : json.AsRaw()) {
+    const auto found = key_indices_.find(key);
+    if (found != key_indices_.end()) {
+      WriteVarint(static_cast<u64>(found->second) + 1, output);
+    } else {
+      WriteVarint(0, output);
+      WriteVarint(key.size(), output);
+      output += key;
+      if (keys_.size() < FlatJsonBinary::kMaxInternedKeys) {
+        key_indices_.emplace(key, static_cast<u32>(keys_.size()));
+        keys_.push_back(key);
+      }
+    }
+
+    if (std::holds_alternative<bool>(value)) {
+      output.push_back(static_cast<char>(
+          std::get<bool>(value) ? FlatJsonBinary::kTrue
+                                : FlatJsonBinary::kFalse));
+    } else if (std::holds_alternative<double>(value)) {
+      const auto number = std::get<double>(value);
+      if (std::trunc(number) == number &&
+          std::abs(number) <= FlatJson::kMaxSafeInteger) {
+        output.push_back(static_cast<char>(FlatJsonBinary::kInteger));
+        WriteVarint(ZigZagEncode(static_cast<i64>(number)), output);
+      } else {
+        u64 bits{};
+        std::memcpy(&bits, &number, sizeof(bits));
+        output.push_back(static_cast<char>(FlatJsonBinary::kDouble));
+        for (u32 i = 0; i < sizeof(bits); ++i) {
+          output.push_back(static_cast<char>((bits >> (i * 8)) & 0xff));
+        }
+      }
+    } else if (std::holds_alternative<std::string>(value)) {
+      const auto& str = std::get<std::string>(value);
+      output.push_back(static_cast<char>(FlatJsonBinary::kString));
+      WriteVarint(str.size(), output);
+      output += str;
+    }
+  }
+}
+
+auto
+kero::FlatJsonBinaryEncoder::GetKeys() const noexcept
+    -> const std::vector<std::string>& {
+  return keys_;
+}
+
+kero::FlatJsonBinaryDecoder::FlatJsonBinaryDecoder(
+    std::vector<std::string>&& keys) noexcept
+    : keys_{std::move(keys)} {}
+
+auto
+kero::FlatJsonBinaryDecoder::Decode(const std::string_view input) noexcept
+    -> Result<FlatJson> {
+  using ResultT = Result<FlatJson>;
+
+  size_t pos{};
+  auto count_res = ReadVarint(input, pos);
+  if (count_res.IsErr()) {
+    return ResultT::Err(count_res.TakeErr());
+  }
+
+  FlatJson json{};
+  const auto count = count_res.TakeOk();
+  for (u64 i = 0; i < count; ++i) {
+    auto key_ref_res = ReadVarint(input, pos);
+    if (key_ref_res.IsErr()) {
+      return ResultT::Err(key_ref_res.TakeErr());
+    }
+
+    std::string key;
+    const auto key_ref = key_ref_res.TakeOk();
+    if (key_ref == 0) {
+      auto key_res = ReadString(input, pos);
+      if (key_res.IsErr()) {
+        return ResultT::Err(key_res.TakeErr());
+      }
+
+      key = key_res.TakeOk();
+      if (keys_.size() < FlatJsonBinary::kMaxInternedKeys) {
+        keys_.push_back(key);
+      }
+    } else if (key_ref <= keys_.size()) {
+      key = keys_[key_ref - 1];
+    } else {
+      return ResultT::Err(
+          Error::From(FlatJsonBinary::kInvalidKeyIndex,
+                      FlatJson{}.Set("key_index", key_ref - 1).Take()));
+    }
+
+    if (pos >= input.size()) {
+      return ResultT::Err(Error::From(FlatJsonBinary::kUnexpectedEnd));
+    }
+
+    const auto tag = static_cast<u8>(input[pos++]);
+    switch (tag) {
+      case FlatJsonBinary::kFalse:
+      case FlatJsonBinary::kTrue:
+        (void)json.Set(std::move(key), tag == FlatJsonBinary::kTrue);
+        break;
+      case FlatJsonBinary::kInteger: {
+        auto value_res = ReadVarint(input, pos);
+        if (value_res.IsErr()) {
+          return ResultT::Err(value_res.TakeErr());
+        }
+
+        (void)json.Set(std::move(key),
+                       static_cast<double>(ZigZagDecode(value_res.TakeOk())));
+        break;
+      }
+      case FlatJsonBinary::kDouble: {
+        u64 bits{};
+        if (input.size() - pos < sizeof(bits)) {
+          return ResultT::Err(Error::From(FlatJsonBinary::kUnexpectedEnd));
+        }
+
+        for (u32 j = 0; j < sizeof(bits); ++j) {
+          bits |= static_cast<u64>(static_cast<u8>(input[pos++])) << (j * 8);
+        }
+
+        double number{};
+        std::memcpy(&number, &bits, sizeof(number));
+        (void)json.Set(std::move(key), number);
+        break;
+      }
+      case FlatJsonBinary::kString: {
+        auto value_res = ReadString(input, pos);
+        if (value_res.IsErr()) {
+          return ResultT::Err(value_res.TakeErr());
+        }
+
+        (void)json.Set(std::move(key), value_res.TakeOk());
+        break;
+      }
+      default:
+        return ResultT::Err(
+            Error::From(FlatJsonBinary::kInvalidTag,
+                        FlatJson{}.Set("tag", tag).Take()));
+    }
+  }
+
+  if (pos != input.size()) {
+    return ResultT::Err(
+        Error::From(FlatJsonBinary::kTrailingBytes,
+                    FlatJson{}
+                        .Set("trailing", static_cast<u64>(input.size() - pos))
+                        .Take()));
+  }
+
+  return ResultT::Ok(std::move(json));
+}
+
+auto
+kero::FlatJsonBinaryDecoder::GetKeys() const noexcept
+    -> const std::vector<std::string>& {
+  return keys_;
+}
@@ -0,0 +1,97 @@
+#ifndef KERO_CORE_FLAT_JSON_BINARY_H
+#define KERO_CORE_FLAT_JSON_BINARY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "kero/core/common.h"
+#include "kero/core/flat_json.h"
+#include "kero/core/result.h"
+
+namespace kero {
+
+/**
+ * Binary layout of a `FlatJson`:
+ *
+ *   object := varint(field count) field*
+ *   field  := key value
+ *   key    := varint(0) varint(size) bytes   ; literal, interned if room
+ *           | varint(index + 1)              ; interned key
+ *   value  := kFalse | kTrue
+ *           | kInteger varint(zigzag(i64))
+ *           | kDouble  8 bytes, little-endian IEEE 754
+ *           | kString  varint(size) bytes
+ *
+ * Keys are interned per direction of a connection: the encoder and the
+ * decoder of one direction grow the same table in the same order, so keys
+ * are sent in full only once.
+ */
+struct FlatJsonBinary {
+  enum : u8 {
+    kFalse = 0,
+    kTrue,
+    kInteger,
+    kDouble,
+    kString,
+  };
+
+  enum : Error::Code {
+    kUnexpectedEnd = 1,
+    kVarintOverflow,
+    kInvalidTag,
+    kInvalidKeyIndex,
+    kTrailingBytes,
+  };
+
+  static constexpr size_t kMaxInternedKeys = 1024;
+};
+
+class FlatJsonBinaryEncoder final {
+ public:
+  explicit FlatJsonBinaryEncoder() noexcept = default;
+
+  /**
+   * Restores an interned key table, see `GetKeys`.
+   */
+  explicit FlatJsonBinaryEncoder(std::vector<std::string>&& keys) noexcept;
+
+  ~FlatJsonBinaryEncoder() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(FlatJsonBinaryEncoder);
+
+  auto
+  Encode(const FlatJson& json, std::string& output) noexcept -> void;
+
+  [[nodiscard]] auto
+  GetKeys() const noexcept -> const std::vector<std::string>&;
+
+ private:
+  std::vector<std::string> keys_;
+  std::unordered_map<std::string, u32> key_indices_;
+};
+
+class FlatJsonBinaryDecoder final {
+ public:
+  explicit FlatJsonBinaryDecoder() noexcept = default;
+
+  /**
+   * Restores an interned key table, see `GetKeys`.
+   */
+  explicit FlatJsonBinaryDecoder(std::vector<std::string>&& keys) noexcept;
+
+  ~FlatJsonBinaryDecoder() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(FlatJsonBinaryDecoder);
+
+  [[nodiscard]] auto
+  Decode(const std::string_view input) noexcept -> Result<FlatJson>;
+
+  [[nodiscard]] auto
+  GetKeys() const noexcept -> const std::vector<std::string>&;
+
+ private:
+  std::vector<std::string> keys_;
+};
+
+}  // namespace kero
+
+#endif  // KERO_CORE_FLAT_JSON_BINARY_H
@@ -2,6 +2,63 @@
 
 using namespace kero;
 
+auto
+kero::AppendJsonEscaped(std::string& out, const std::string_view str) noexcept
+    -> void {
+  // Runs of characters which need no escape are appended at once.
+  size_t run_begin{0};
+  for (size_t i = 0; i < str.size(); ++i) {
+    const auto c = str[i];
+    const char* escaped{};
+    switch (c) {
+      case '"':
+        escaped = "\\\"";
+        break;
+      case '\\':
+        escaped = "\\\\";
+        break;
+      case '/':
+        escaped = "\\/";
+        break;
+      case '\b':
+        escaped = "\\b";
+        break;
+      case '\f':
+        escaped = "\\f";
+        break;
+      case '\n':
+        escaped = "\\n";
+        break;
+      case '\r':
+        escaped = "\\r";
+        break;
+      case '\t':
+        escaped = "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) >= 0x20) {
+          continue;
+        }
+        break;
+    }
+
+    out.append(str, run_begin, i - run_begin);
+    run_begin = i + 1;
+    if (escaped) {
+      out += escaped;
+      continue;
+    }
+
+    constexpr char kHexDigits[] = "0123456789abcdef";
+    const auto byte = static_cast<unsigned char>(c);
+    out += "\\u00";
+    out += kHexDigits[byte >> 4];
+    out += kHexDigits[byte & 0xf];
+  }
+
+  out.append(str, run_begin, str.size() - run_begin);
+}
+
 auto
 kero::FlatJsonStringifier::Stringify(const FlatJson& json) noexcept
     -> Result<std::string> {
@@ -24,39 +81,8 @@ kero::FlatJsonStringifier::Stringify(const FlatJson& json) noexcept
       const auto double_str = std::to_string(std::get<double>(value));
       str += TrimDoubleString(double_str);
     } else if (std::holds_alternative<std::string>(value)) {
-      const auto data = std::get<std::string>(value);
       str += "\"";
-      for (const auto c : data) {
-        switch (c) {
-          case '"':
-            str += "\\\"";
-            break;
-          case '\\':
-            str += "\\\\";
-            break;
-          case '/':
-            str += "\\/";
-            break;
-          case '\b':
-            str += "\\b";
-            break;
-          case '\f':
-            str += "\\f";
-            break;
-          case '\n':
-            str += "\\n";
-            break;
-          case '\r':
-            str += "\\r";
-            break;
-          case '\t':
-            str += "\\t";
-            break;
-          default:
-            str += c;
-            break;
-        }
-      }
+      AppendJsonEscaped(str, std::get<std::string>(value));
       str += "\"";
     } else {
       return ResultT::Err(Error::From(FlatJson{}
@@ -1,10 +1,21 @@
 #ifndef KERO_CORE_FLAT_JSON_PARSER_H
 #define KERO_CORE_FLAT_JSON_PARSER_H
 
+#include <string>
+#include <string_view>
+
 #include "kero/core/result.h"
 
 namespace kero {
 
+/**
+ * Appends `str` escaped as the contents of a JSON string, without quotes.
+ * Control characters without a short escape are written as `\u00XX`.
+ */
+auto
+AppendJsonEscaped(std::string& out, const std::string_view str) noexcept
+    -> void;
+
 class FlatJsonStringifier final {
  public:
   explicit FlatJsonStringifier() noexcept = default;
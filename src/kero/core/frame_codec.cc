@@ -0,0 +1,410 @@
+#include "frame_codec.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "kero/core/flat_json.h"
+#include "kero/core/flat_json_parser.h"
+#include "kero/core/utils.h"
+
+using namespace kero;
+
+auto
+kero::FrameCodec::Get(const FrameFormat format) noexcept -> const FrameCodec& {
+  static const BraceFrameCodec brace{};
+  static const LengthPrefixedFrameCodec length_prefixed{};
+
+  switch (format) {
+    case FrameFormat::kLengthPrefixed:
+      return length_prefixed;
+    case FrameFormat::kBrace:
+    default:
+      return brace;
+  }
+}
+
+auto
+kero::BraceFrameCodec::Decode(const std::string_view input) const noexcept
+    -> Result<DecodedFrame> {
+  using ResultT = Result<DecodedFrame>;
+
+  // Filler, e.g. whitespace between frames, is skipped up to the frame or to
+  // a byte which may start a preface, so a preface after filler or split
+  // across reads is kept for `SocketCodec::Pop`. A leading `K` was already
+  // found not to be a preface there.
+  size_t start = 0;
+  while (start < input.size() && input[start] != '{' &&
+         (start == 0 || input[start] != SocketCodec::kPrefaceMagic.front())) {
+    ++start;
+  }
+
+  if (start == input.size() || input[start] != '{') {
+    return ResultT::Ok(DecodedFrame{.consumed = start});
+  }
+
+  i64 curly_brace_count = 0;
+  for (size_t end = start; end < input.size(); ++end) {
+    if (input[end] == '{') {
+      ++curly_brace_count;
+    } else if (input[end] == '}') {
+      --curly_brace_count;
+    }
+
+    if (curly_brace_count == 0) {
+      return ResultT::Ok(
+          DecodedFrame{.consumed = end + 1,
+                       .payload = input.substr(start, end + 1 - start)});
+    }
+  }
+
+  return ResultT::Ok(DecodedFrame{});
+}
+
+auto
+kero::BraceFrameCodec::Encode(const std::string_view payload,
+                              std::string& output) const noexcept -> void {
+  output += payload;
+}
+
+auto
+kero::LengthPrefixedFrameCodec::Decode(
+    const std::string_view input) const noexcept -> Result<DecodedFrame> {
+  using ResultT = Result<DecodedFrame>;
+
+  if (input.size() < kHeaderSize) {
+    return ResultT::Ok(DecodedFrame{});
+  }
+
+  u32 payload_size{};
+  for (size_t i = 0; i < kHeaderSize; ++i) {
+    payload_size = (payload_size << 8) | static_cast<u8>(input[i]);
+  }
+
+  if (payload_size > kMaxPayloadSize) {
+    return ResultT::Err(Error::From(
+        kFrameTooLarge,
+        FlatJson{}
+            .Set("payload_size", payload_size)
+            .Set("max_payload_size", static_cast<u64>(kMaxPayloadSize))
+            .Take()));
+  }
+
+  if (input.size() < kHeaderSize + payload_size) {
+    return ResultT::Ok(DecodedFrame{});
+  }
+
+  return ResultT::Ok(
+      DecodedFrame{.consumed = kHeaderSize + payload_size,
+                   .payload = input.substr(kHeaderSize, payload_size)});
+}
+
+auto
+kero::LengthPrefixedFrameCodec::Encode(const std::string_view payload,
+                                       std::string& output) const noexcept
+    -> void {
+  const auto payload_size = static_cast<u32>(payload.size());
+  output.reserve(output.size() + kHeaderSize + payload.size());
+  output.push_back(static_cast<char>((payload_size >> 24) & 0xff));
+  output.push_back(static_cast<char>((payload_size >> 16) & 0xff));
+  output.push_back(static_cast<char>((payload_size >> 8) & 0xff));
+  output.push_back(static_cast<char>(payload_size & 0xff));
+  output += payload;
+}
+
+auto
+kero::SocketCodec::Push(const std::string_view input) noexcept -> void {
+  if (offset_ > 0) {
+    buffer_.erase(0, offset_);
+    offset_ = 0;
+  }
+
+  buffer_ += input;
+}
+
+auto
+kero::SocketCodec::Pop(std::string& payload) noexcept -> Result<bool> {
+  using ResultT = Result<bool>;
+
+  while (offset_ < buffer_.size()) {
+    const auto input = std::string_view{buffer_}.substr(offset_);
+    if (input.front() == kPrefaceMagic.front()) {
+      const auto size = std::min(input.size(), kPrefaceMagic.size());
+      if (input.substr(0, size) == kPrefaceMagic.substr(0, size)) {
+        if (input.size() < kPrefaceSize) {
+          return ResultT::Ok(false);
+        }
+
+        auto format_res =
+            ValidateFormat(static_cast<u8>(input[kPrefaceSize - 2]),
+                           static_cast<u8>(input[kPrefaceSize - 1]));
+        if (format_res.IsErr()) {
+          DiscardBuffered();
+          return ResultT::Err(format_res.TakeErr());
+        }
+
+        read_format_ = format_res.TakeOk();
+        upgraded_ = true;
+        offset_ += kPrefaceSize;
+        continue;
+      }
+    }
+
+    auto decoded_res = FrameCodec::Get(read_format_.frame).Decode(input);
+    if (decoded_res.IsErr()) {
+      DiscardBuffered();
+      return ResultT::Err(decoded_res.TakeErr());
+    }
+
+    const auto decoded = decoded_res.TakeOk();
+    if (decoded.consumed == 0) {
+      return ResultT::Ok(false);
+    }
+
+    offset_ += decoded.consumed;
+    if (decoded.payload.empty()) {
+      continue;
+    }
+
+    payload.assign(decoded.payload);
+    return ResultT::Ok(true);
+  }
+
+  return ResultT::Ok(false);
+}
+
+auto
+kero::SocketCodec::DiscardBuffered() noexcept -> void {
+  buffer_.clear();
+  buffer_.shrink_to_fit();
+  offset_ = 0;
+}
+
+auto
+kero::SocketCodec::DecodePayload(const std::string_view payload) noexcept
+    -> Result<FlatJson> {
+  if (read_format_.payload == PayloadFormat::kFlatJsonBinary) {
+    return decoder_.Decode(payload);
+  }
+
+  return FlatJsonParser{}.Parse(payload);
+}
+
+auto
+kero::SocketCodec::EncodeFrame(const FlatJson& data) noexcept
+    -> Result<std::string> {
+  using ResultT = Result<std::string>;
+
+  std::string payload;
+  if (write_format_.payload == PayloadFormat::kFlatJsonBinary) {
+    encoder_.Encode(data, payload);
+  } else {
+    auto stringified = FlatJsonStringifier{}.Stringify(data);
+    if (stringified.IsErr()) {
+      return ResultT::Err(stringified.TakeErr());
+    }
+
+    payload = stringified.TakeOk();
+  }
+
+  std::string frame;
+  FrameCodec::Get(write_format_.frame).Encode(payload, frame);
+  return ResultT::Ok(std::move(frame));
+}
+
+auto
+kero::SocketCodec::EncodeFrame(const FrameTemplate& frame_template,
+                               const std::span<const u64> values) noexcept
+    -> Result<std::string> {
+  using ResultT = Result<std::string>;
+
+  std::string payload;
+  if (write_format_.payload == PayloadFormat::kFlatJsonBinary) {
+    auto data = frame_template.ToFlatJson(values);
+    if (data.IsErr()) {
+      return ResultT::Err(data.TakeErr());
+    }
+
+    encoder_.Encode(data.Ok(), payload);
+  } else {
+    frame_template.Render(values, payload);
+  }
+
+  // A brace frame is the payload itself.
+  if (write_format_.frame == FrameFormat::kBrace) {
+    return ResultT::Ok(std::move(payload));
+  }
+
+  std::string frame;
+  FrameCodec::Get(write_format_.frame).Encode(payload, frame);
+  return ResultT::Ok(std::move(frame));
+}
+
+auto
+kero::SocketCodec::SwitchWriteFormat(const WireFormat format) noexcept
+    -> std::string {
+  write_format_ = format;
+
+  std::string preface{kPrefaceMagic};
+  preface.push_back(static_cast<char>(format.frame));
+  preface.push_back(static_cast<char>(format.payload));
+  return preface;
+}
+
+auto
+kero::SocketCodec::TakeUpgraded() noexcept -> bool {
+  return std::exchange(upgraded_, false);
+}
+
+auto
+kero::SocketCodec::GetReadFormat() const noexcept -> WireFormat {
+  return read_format_;
+}
+
+auto
+kero::SocketCodec::GetWriteFormat() const noexcept -> WireFormat {
+  return write_format_;
+}
+
+auto
+kero::SocketCodec::HasBuffered() const noexcept -> bool {
+  return offset_ < buffer_.size();
+}
+
+auto
+kero::SocketCodec::Export() noexcept -> FlatJson {
+  FlatJson data{};
+  (void)data.Set(kReadFrameFormat, static_cast<u8>(read_format_.frame))
+      .Set(kReadPayloadFormat, static_cast<u8>(read_format_.payload))
+      .Set(kWriteFrameFormat, static_cast<u8>(write_format_.frame))
+      .Set(kWritePayloadFormat, static_cast<u8>(write_format_.payload))
+      .Set(kBuffered, buffer_.substr(offset_));
+
+  const auto& read_keys = decoder_.GetKeys();
+  (void)data.Set(kReadKeyCount, static_cast<u64>(read_keys.size()));
+  for (size_t i = 0; i < read_keys.size(); ++i) {
+    (void)data.Set(kReadKeyPrefix + std::to_string(i), read_keys[i]);
+  }
+
+  const auto& write_keys = encoder_.GetKeys();
+  (void)data.Set(kWriteKeyCount, static_cast<u64>(write_keys.size()));
+  for (size_t i = 0; i < write_keys.size(); ++i) {
+    (void)data.Set(kWriteKeyPrefix + std::to_string(i), write_keys[i]);
+  }
+
+  *this = SocketCodec{};
+  return data;
+}
+
+auto
+kero::SocketCodec::Import(const FlatJson& data) noexcept
+    -> Result<SocketCodec> {
+  using ResultT = Result<SocketCodec>;
+
+  // Key tables are restored in order, a gap would desync the peer.
+  const auto import_keys = [&data](const std::string& count_key,
+                                   const std::string& prefix)
+      -> Result<std::vector<std::string>> {
+    using ResultT = Result<std::vector<std::string>>;
+
+    std::vector<std::string> keys;
+    const auto count = data.TryGet<u64>(count_key);
+    if (!count) {
+      return ResultT::Ok(std::move(keys));
+    }
+
+    keys.reserve(count.Unwrap());
+    for (u64 i = 0; i < count.Unwrap(); ++i) {
+      const auto key = data.TryGet<std::string>(prefix + std::to_string(i));
+      if (!key) {
+        return ResultT::Err(Error::From(
+            FlatJson{}
+                .Set("message", std::string{"Interned key not found"})
+                .Set("index", i)
+                .Take()));
+      }
+
+      keys.push_back(key.Unwrap());
+    }
+
+    return ResultT::Ok(std::move(keys));
+  };
+
+  SocketCodec codec{};
+  const auto read_frame = data.TryGet<u8>(kReadFrameFormat);
+  const auto read_payload = data.TryGet<u8>(kReadPayloadFormat);
+  if (read_frame && read_payload) {
+    auto format = ValidateFormat(read_frame.Unwrap(), read_payload.Unwrap());
+    if (format.IsErr()) {
+      return ResultT::Err(format.TakeErr());
+    }
+
+    codec.read_format_ = format.TakeOk();
+  }
+
+  const auto write_frame = data.TryGet<u8>(kWriteFrameFormat);
+  const auto write_payload = data.TryGet<u8>(kWritePayloadFormat);
+  if (write_frame && write_payload) {
+    auto format = ValidateFormat(write_frame.Unwrap(), write_payload.Unwrap());
+    if (format.IsErr()) {
+      return ResultT::Err(format.TakeErr());
+    }
+
+    codec.write_format_ = format.TakeOk();
+  }
+
+  const auto buffered = data.TryGet<std::string>(kBuffered);
+  if (buffered) {
+    codec.buffer_ = buffered.Unwrap();
+  }
+
+  auto decoder_keys = import_keys(kReadKeyCount, kReadKeyPrefix);
+  if (decoder_keys.IsErr()) {
+    return ResultT::Err(decoder_keys.TakeErr());
+  }
+
+  auto encoder_keys = import_keys(kWriteKeyCount, kWriteKeyPrefix);
+  if (encoder_keys.IsErr()) {
+    return ResultT::Err(encoder_keys.TakeErr());
+  }
+
+  codec.decoder_ = FlatJsonBinaryDecoder{decoder_keys.TakeOk()};
+  codec.encoder_ = FlatJsonBinaryEncoder{encoder_keys.TakeOk()};
+  return ResultT::Ok(std::move(codec));
+}
+
+auto
+kero::SocketCodec::ValidateFormat(const u8 frame_format,
+                                  const u8 payload_format) noexcept
+    -> Result<WireFormat> {
+  using ResultT = Result<WireFormat>;
+
+  if (frame_format != static_cast<u8>(FrameFormat::kBrace) &&
+      frame_format != static_cast<u8>(FrameFormat::kLengthPrefixed)) {
+    return ResultT::Err(Error::From(
+        FrameCodec::kUnsupportedFrameFormat,
+        FlatJson{}.Set("frame_format", frame_format).Take()));
+  }
+
+  if (payload_format != static_cast<u8>(PayloadFormat::kFlatJsonText) &&
+      payload_format != static_cast<u8>(PayloadFormat::kFlatJsonBinary)) {
+    return ResultT::Err(Error::From(
+        FrameCodec::kUnsupportedPayloadFormat,
+        FlatJson{}.Set("payload_format", payload_format).Take()));
+  }
+
+  // A brace frame ends at the first unbalanced `}`, which binary payloads
+  // may contain anywhere.
+  if (frame_format == static_cast<u8>(FrameFormat::kBrace) &&
+      payload_format == static_cast<u8>(PayloadFormat::kFlatJsonBinary)) {
+    return ResultT::Err(Error::From(
+        FrameCodec::kUnsupportedPayloadFormat,
+        FlatJson{}
+            .Set("frame_format", frame_format)
+            .Set("payload_format", payload_format)
+            .Take()));
+  }
+
+  return ResultT::Ok(
+      WireFormat{.frame = static_cast<FrameFormat>(frame_format),
+                 .payload = static_cast<PayloadFormat>(payload_format)});
+}
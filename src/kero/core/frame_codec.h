@@ -0,0 +1,233 @@
+#ifndef KERO_CORE_FRAME_CODEC_H
+#define KERO_CORE_FRAME_CODEC_H
+
+#include <span>
+#include <string>
+
+#include "kero/core/common.h"
+#include "kero/core/flat_json.h"
+#include "kero/core/flat_json_binary.h"
+#include "kero/core/frame_template.h"
+#include "kero/core/result.h"
+
+namespace kero {
+
+enum class FrameFormat : u8 {
+  kBrace = 0,
+  kLengthPrefixed = 1,
+};
+
+enum class PayloadFormat : u8 {
+  kFlatJsonText = 0,
+
+  /**
+   * See `FlatJsonBinary`. Needs a frame format which is not brace.
+   */
+  kFlatJsonBinary = 1,
+};
+
+struct WireFormat {
+  FrameFormat frame{FrameFormat::kBrace};
+  PayloadFormat payload{PayloadFormat::kFlatJsonText};
+};
+
+struct DecodedFrame {
+  /**
+   * Bytes of the input taken by this frame. Zero means the input does not hold
+   * a complete frame yet.
+   */
+  size_t consumed{};
+
+  /**
+   * Views into the decoded input. May be empty when only filler bytes were
+   * consumed.
+   */
+  std::string_view payload{};
+};
+
+class FrameCodec {
+ public:
+  enum : Error::Code {
+    kFrameTooLarge = 1,
+    kUnsupportedFrameFormat,
+    kUnsupportedPayloadFormat,
+  };
+
+  explicit FrameCodec() noexcept = default;
+  virtual ~FrameCodec() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(FrameCodec);
+
+  [[nodiscard]] virtual auto
+  Decode(const std::string_view input) const noexcept
+      -> Result<DecodedFrame> = 0;
+
+  virtual auto
+  Encode(const std::string_view payload,
+         std::string& output) const noexcept -> void = 0;
+
+  [[nodiscard]] static auto
+  Get(const FrameFormat format) noexcept -> const FrameCodec&;
+};
+
+/**
+ * Legacy framing: a frame is a balanced `{...}` block, found by scanning every
+ * byte. Only text payloads can be carried.
+ */
+class BraceFrameCodec final : public FrameCodec {
+ public:
+  explicit BraceFrameCodec() noexcept = default;
+  virtual ~BraceFrameCodec() noexcept override = default;
+  KERO_CLASS_KIND_PINNABLE(BraceFrameCodec);
+
+  [[nodiscard]] virtual auto
+  Decode(const std::string_view input) const noexcept
+      -> Result<DecodedFrame> override;
+
+  virtual auto
+  Encode(const std::string_view payload,
+         std::string& output) const noexcept -> void override;
+};
+
+/**
+ * A frame is a big-endian u32 payload length followed by the payload, so a
+ * frame is found without looking at its payload.
+ */
+class LengthPrefixedFrameCodec final : public FrameCodec {
+ public:
+  explicit LengthPrefixedFrameCodec() noexcept = default;
+  virtual ~LengthPrefixedFrameCodec() noexcept override = default;
+  KERO_CLASS_KIND_PINNABLE(LengthPrefixedFrameCodec);
+
+  [[nodiscard]] virtual auto
+  Decode(const std::string_view input) const noexcept
+      -> Result<DecodedFrame> override;
+
+  virtual auto
+  Encode(const std::string_view payload,
+         std::string& output) const noexcept -> void override;
+
+  static constexpr size_t kHeaderSize = 4;
+  static constexpr size_t kMaxPayloadSize = 1 << 20;
+};
+
+/**
+ * Per connection framing state.
+ *
+ * Both directions start with brace framing and switch independently. At any
+ * frame boundary a side may send the preface `KERO<frame format><payload
+ * format>`; every frame it sends after the preface uses the announced formats.
+ * No frame of either format starts with `K`, so the preface is never mistaken
+ * for a frame. A server answers a preface with its own, see `TakeUpgraded`.
+ */
+class SocketCodec final {
+ public:
+  explicit SocketCodec() noexcept = default;
+  ~SocketCodec() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(SocketCodec);
+
+  auto
+  Push(const std::string_view input) noexcept -> void;
+
+  /**
+   * Returns `true` and sets `payload` when a complete frame was decoded.
+   *
+   * An error means the stream cannot be framed again, such as a frame over
+   * the size limit or a bad preface. The bytes buffered so far are dropped,
+   * and the connection should be closed.
+   */
+  [[nodiscard]] auto
+  Pop(std::string& payload) noexcept -> Result<bool>;
+
+  /**
+   * Decodes a payload returned by `Pop` according to the read format.
+   */
+  [[nodiscard]] auto
+  DecodePayload(const std::string_view payload) noexcept -> Result<FlatJson>;
+
+  /**
+   * Encodes `data` in the write format and wraps it in a frame.
+   */
+  [[nodiscard]] auto
+  EncodeFrame(const FlatJson& data) noexcept -> Result<std::string>;
+
+  /**
+   * Like `EncodeFrame`, but renders `frame_template` instead of stringifying
+   * a `FlatJson`. Binary payloads are encoded from
+   * `FrameTemplate::ToFlatJson`.
+   */
+  [[nodiscard]] auto
+  EncodeFrame(const FrameTemplate& frame_template,
+              const std::span<const u64> values) noexcept
+      -> Result<std::string>;
+
+  /**
+   * Switches the write format and returns the preface which must be sent
+   * before the next frame.
+   */
+  [[nodiscard]] auto
+  SwitchWriteFormat(const WireFormat format) noexcept -> std::string;
+
+  /**
+   * Returns `true` once after a received preface switched the read format.
+   */
+  [[nodiscard]] auto
+  TakeUpgraded() noexcept -> bool;
+
+  /**
+   * Moves the state of the connection, including bytes not decoded yet and the
+   * interned key tables, into a `FlatJson` so another runner can `Import` it.
+   */
+  [[nodiscard]] auto
+  Export() noexcept -> FlatJson;
+
+  /**
+   * Restores an exported state. Missing keys keep their defaults.
+   */
+  [[nodiscard]] static auto
+  Import(const FlatJson& data) noexcept -> Result<SocketCodec>;
+
+  [[nodiscard]] auto
+  GetReadFormat() const noexcept -> WireFormat;
+
+  [[nodiscard]] auto
+  GetWriteFormat() const noexcept -> WireFormat;
+
+  /**
+   * Whether bytes were pushed which `Pop` did not consume yet.
+   */
+  [[nodiscard]] auto
+  HasBuffered() const noexcept -> bool;
+
+  static constexpr std::string_view kPrefaceMagic{"KERO"};
+  static constexpr size_t kPrefaceSize = kPrefaceMagic.size() + 2;
+
+  static constexpr auto kReadFrameFormat = "codec_read_frame_format";
+  static constexpr auto kReadPayloadFormat = "codec_read_payload_format";
+  static constexpr auto kWriteFrameFormat = "codec_write_frame_format";
+  static constexpr auto kWritePayloadFormat = "codec_write_payload_format";
+  static constexpr auto kBuffered = "codec_buffered";
+  static constexpr auto kReadKeyCount = "codec_read_key_count";
+  static constexpr auto kReadKeyPrefix = "codec_read_key_";
+  static constexpr auto kWriteKeyCount = "codec_write_key_count";
+  static constexpr auto kWriteKeyPrefix = "codec_write_key_";
+
+ private:
+  [[nodiscard]] static auto
+  ValidateFormat(const u8 frame_format, const u8 payload_format) noexcept
+      -> Result<WireFormat>;
+
+  auto
+  DiscardBuffered() noexcept -> void;
+
+  std::string buffer_;
+  size_t offset_{};
+  WireFormat read_format_{};
+  WireFormat write_format_{};
+  FlatJsonBinaryDecoder decoder_{};
+  FlatJsonBinaryEncoder encoder_{};
+  bool upgraded_{false};
+};
+
+}  // namespace kero
+
+#endif  // KERO_CORE_FRAME_CODEC_H
@@ -0,0 +1,119 @@
+#include "frame_template.h"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+
+#include "kero/core/flat_json_parser.h"
+
+using namespace kero;
+
+kero::FrameTemplate::FrameTemplate(const std::string_view pattern) noexcept {
+  size_t start{};
+  while (true) {
+    const auto slot = pattern.find(kSlot, start);
+    literals_.emplace_back(pattern.substr(start, slot - start));
+    literal_size_ += literals_.back().size();
+    if (slot == std::string_view::npos) {
+      break;
+    }
+
+    start = slot + 1;
+  }
+
+  for (size_t i = 0; i + 1 < literals_.size(); ++i) {
+    auto key = FindSlotKey(literals_[i]);
+    if (key.empty()) {
+      slot_keys_.clear();
+      return;
+    }
+
+    slot_keys_.push_back(std::move(key));
+  }
+
+  std::string payload;
+  Render({}, payload);
+  auto parsed = FlatJsonParser{}.Parse(payload);
+  if (parsed.IsErr()) {
+    slot_keys_.clear();
+    return;
+  }
+
+  parsed_ = parsed.TakeOk();
+}
+
+auto
+kero::FrameTemplate::Render(const std::span<const u64> values,
+                            std::string& output) const noexcept -> void {
+  constexpr size_t kMaxDigits = std::numeric_limits<u64>::digits10 + 1;
+
+  output.reserve(output.size() + literal_size_ +
+                 GetSlotCount() * kMaxDigits);
+  output += literals_.front();
+  for (size_t i = 1; i < literals_.size(); ++i) {
+    const auto value = i - 1 < values.size() ? values[i - 1] : u64{};
+    char digits[kMaxDigits];
+    const auto [end, _] = std::to_chars(digits, digits + kMaxDigits, value);
+    output.append(digits, end);
+    output += literals_[i];
+  }
+}
+
+auto
+kero::FrameTemplate::ToFlatJson(const std::span<const u64> values)
+    const noexcept -> Result<FlatJson> {
+  using ResultT = Result<FlatJson>;
+
+  if (slot_keys_.size() != GetSlotCount()) {
+    std::string payload;
+    Render(values, payload);
+    return FlatJsonParser{}.Parse(payload);
+  }
+
+  auto data = parsed_.Clone();
+  for (size_t i = 0; i < slot_keys_.size(); ++i) {
+    data.AsRaw().insert_or_assign(
+        slot_keys_[i],
+        static_cast<double>(i < values.size() ? values[i] : u64{}));
+  }
+
+  return ResultT::Ok(std::move(data));
+}
+
+auto
+kero::FrameTemplate::FindSlotKey(const std::string_view literal) noexcept
+    -> std::string {
+  constexpr std::string_view kWhitespace{" \t\r\n"};
+
+  auto rest = literal.substr(0, literal.find_last_not_of(kWhitespace) + 1);
+  if (!rest.ends_with(':')) {
+    return {};
+  }
+
+  rest.remove_suffix(1);
+  rest = rest.substr(0, rest.find_last_not_of(kWhitespace) + 1);
+  if (!rest.ends_with('"')) {
+    return {};
+  }
+
+  rest.remove_suffix(1);
+  const auto open = rest.rfind('"');
+  if (open == std::string_view::npos) {
+    return {};
+  }
+
+  // Keys with escapes, whose quote may be escaped too, are left to the
+  // parser.
+  const auto key = rest.substr(open + 1);
+  if ((open > 0 && rest[open - 1] == '\\') ||
+      std::ranges::find(key, '\\') != key.end()) {
+    return {};
+  }
+
+  return std::string{key};
+}
+
+auto
+kero::FrameTemplate::GetSlotCount() const noexcept -> size_t {
+  return literals_.size() - 1;
+}
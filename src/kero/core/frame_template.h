@@ -0,0 +1,74 @@
+#ifndef KERO_CORE_FRAME_TEMPLATE_H
+#define KERO_CORE_FRAME_TEMPLATE_H
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kero/core/common.h"
+#include "kero/core/flat_json.h"
+#include "kero/core/result.h"
+
+namespace kero {
+
+/**
+ * A text payload with numeric slots, split once up front so rendering it only
+ * copies the literal parts and formats the numbers between them.
+ *
+ * Slots are marked with `$` in the pattern, e.g.
+ * `{"event":"battle_result","result":$}`. The pattern must be FlatJson text
+ * once every slot holds a number, and may not contain `$` otherwise.
+ *
+ * The pattern is also parsed once, so payload formats which are not text
+ * start from its values instead of parsing every rendered payload.
+ */
+class FrameTemplate final {
+ public:
+  explicit FrameTemplate(const std::string_view pattern) noexcept;
+  ~FrameTemplate() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(FrameTemplate);
+
+  /**
+   * Appends the payload with `values` in the slots, in order. Slots without a
+   * value hold `0`.
+   */
+  auto
+  Render(const std::span<const u64> values,
+         std::string& output) const noexcept -> void;
+
+  /**
+   * Returns the payload as a `FlatJson`, with `values` in the slots like
+   * `Render`.
+   */
+  [[nodiscard]] auto
+  ToFlatJson(const std::span<const u64> values) const noexcept
+      -> Result<FlatJson>;
+
+  [[nodiscard]] auto
+  GetSlotCount() const noexcept -> size_t;
+
+  static constexpr char kSlot{'$'};
+
+ private:
+  /**
+   * Returns the key of the slot which follows `literal`, which ends with
+   * `"key":`, or an empty string.
+   */
+  [[nodiscard]] static auto
+  FindSlotKey(const std::string_view literal) noexcept -> std::string;
+
+  std::vector<std::string> literals_;
+  size_t literal_size_{};
+
+  /**
+   * Empty when a slot key could not be found, `ToFlatJson` then parses the
+   * rendered payload.
+   */
+  std::vector<std::string> slot_keys_;
+  FlatJson parsed_{};
+};
+
+}  // namespace kero
+
+#endif  // KERO_CORE_FRAME_TEMPLATE_H
@@ -0,0 +1,130 @@
+#ifndef KERO_CORE_SPSC_RING_H
+#define KERO_CORE_SPSC_RING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+#include "kero/core/common.h"
+
+namespace kero {
+namespace spsc {
+
+/**
+ * Bounded single producer, single consumer ring of trivially copyable values.
+ *
+ * Unlike `Queue`, pushing never allocates: values are copied into slots
+ * owned by the ring, and a full ring rejects the push. Each side caches the
+ * index of the other, so it only touches the shared index when its cached
+ * view says the ring is full or empty.
+ */
+template <typename T, size_t Capacity>
+  requires std::is_trivially_copyable_v<T> &&
+           (Capacity > 0 && (Capacity & (Capacity - 1)) == 0)
+class Ring final {
+ public:
+  explicit Ring() noexcept = default;
+  ~Ring() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(Ring);
+
+  [[nodiscard]] auto
+  TryPush(const T& value) noexcept -> bool {
+    return TryPushWith([&value](T& slot) noexcept { slot = value; });
+  }
+
+  /**
+   * Lets `write` fill the free slot in place, so a large value need not be
+   * copied whole.
+   */
+  template <typename Write>
+  [[nodiscard]] auto
+  TryPushWith(Write&& write) noexcept -> bool {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - producer_head_ == Capacity) {
+      producer_head_ = head_.load(std::memory_order_acquire);
+      if (tail - producer_head_ == Capacity) {
+        return false;
+      }
+    }
+
+    std::forward<Write>(write)(slots_[tail & (Capacity - 1)]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  [[nodiscard]] auto
+  TryPop(T& value) noexcept -> bool {
+    return TryPopWith([&value](const T& slot) noexcept { value = slot; });
+  }
+
+  /**
+   * Lets `read` use the oldest slot in place before it is released.
+   */
+  template <typename Read>
+  [[nodiscard]] auto
+  TryPopWith(Read&& read) noexcept -> bool {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == consumer_tail_) {
+      consumer_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == consumer_tail_) {
+        return false;
+      }
+    }
+
+    std::forward<Read>(read)(slots_[head & (Capacity - 1)]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Visits the queued values, oldest first, without releasing them or
+   * synchronizing with either side. Only for last-resort readers such as a
+   * crash handler: a value may be read while it is popped or overwritten.
+   */
+  template <typename Visit>
+  auto
+  VisitUnsynchronized(Visit&& visit) const noexcept -> void {
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto tail = tail_.load(std::memory_order_acquire);
+    const auto size = std::min<u64>(tail - head, Capacity);
+    for (u64 i = tail - size; i != tail; ++i) {
+      visit(slots_[i & (Capacity - 1)]);
+    }
+  }
+
+  /**
+   * Approximate when read by a thread which is neither side.
+   */
+  [[nodiscard]] auto
+  Size() const noexcept -> size_t {
+    // The head never passes the tail, so it is read first.
+    const auto head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+
+  [[nodiscard]] auto
+  IsEmpty() const noexcept -> bool {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t kCapacity{Capacity};
+
+ private:
+  // Written by the consumer.
+  alignas(64) std::atomic<u64> head_{};
+  u64 consumer_tail_{};
+
+  // Written by the producer.
+  alignas(64) std::atomic<u64> tail_{};
+  u64 producer_head_{};
+
+  alignas(64) std::array<T, Capacity> slots_;
+};
+
+}  // namespace spsc
+}  // namespace kero
+
+#endif  // KERO_CORE_SPSC_RING_H
@@ -2,6 +2,7 @@
 
 #include "kero/engine/engine.h"
 #include "kero/engine/runner_context.h"
+#include "kero/engine/signal_service.h"
 #include "kero/log/log_builder.h"
 
 using namespace kero;
@@ -21,6 +22,14 @@ kero::ActorService::OnUpdate() noexcept -> void {
   }
 
   auto [from, to, event, body] = mail.TakeUnwrap();
+  if (event == EventShutdown::kEvent) {
+    // Services see the shutdown through `OnShutdown` instead of an event.
+    const auto timeout_ms = body.TryGet<u64>(EventShutdown::kTimeoutMs);
+    RequestShutdown(timeout_ms ? timeout_ms.Unwrap()
+                               : SignalService::kDefaultShutdownTimeoutMs);
+    return;
+  }
+
   if (auto res = InvokeEvent(event,
                              body.Set("__from", std::string{from})
                                  .Set("__to", std::string{to})
@@ -19,8 +19,13 @@ enum : ServiceKindId {
   kServiceKindId_EngineEnd,
 };
 
+/**
+ * Broadcast once by `SignalService`. Each runner then stops taking new work,
+ * waits for its services to drain up to `kTimeoutMs` and destroys them.
+ */
 struct EventShutdown {
   static constexpr auto kEvent = "shutdown";
+  static constexpr auto kTimeoutMs = "timeout_ms";
 };
 
 }  // namespace kero
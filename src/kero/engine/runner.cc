@@ -25,21 +25,42 @@ kero::Runner::Run() noexcept -> Result<Void> {
 
   auto signal_service =
       runner_context_->service_map_.GetService<SignalService>();
-  auto is_interrupted = false;
-  while (!is_interrupted) {
-    if (signal_service) {
-      is_interrupted = signal_service.Unwrap()->IsInterrupted();
-    }
-
+  auto is_shutting_down = false;
+  while (true) {
     if (auto res = runner_context_->service_map_.InvokeUpdate(); res.IsErr()) {
       log::Error("service update failed").Data("error", res.TakeErr()).Log();
     }
+
+    if (!runner_context_->IsShutdownRequested()) {
+      continue;
+    }
+
+    if (!is_shutting_down) {
+      is_shutting_down = true;
+      log::Info("Runner shutting down")
+          .Data("name", runner_context_->GetName())
+          .Log();
+      runner_context_->service_map_.InvokeShutdown();
+    }
+
+    if (runner_context_->service_map_.IsDrained()) {
+      break;
+    }
+
+    if (runner_context_->IsShutdownDeadlinePassed()) {
+      log::Warn("Runner shutdown deadline passed before services drained")
+          .Data("name", runner_context_->GetName())
+          .Log();
+      break;
+    }
   }
 
+  // Read before the services are destroyed, `signal_service` borrows one.
+  const auto is_interrupted =
+      signal_service && signal_service.Unwrap()->IsInterrupted();
   runner_context_->service_map_.InvokeDestroy();
-
   if (is_interrupted) {
-    return ResultT::Err(Error::From(kInterrupted));
+    return ResultT::Err(kInterrupted);
   }
 
   return OkVoid();
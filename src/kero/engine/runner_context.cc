@@ -121,3 +121,24 @@ auto
 kero::RunnerContext::GetName() const noexcept -> const std::string& {
   return runner_name_;
 }
+
+auto
+kero::RunnerContext::RequestShutdown(const u64 timeout_ms) noexcept -> void {
+  if (shutdown_deadline_) {
+    return;
+  }
+
+  shutdown_deadline_ =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds{timeout_ms};
+}
+
+auto
+kero::RunnerContext::IsShutdownRequested() const noexcept -> bool {
+  return shutdown_deadline_.has_value();
+}
+
+auto
+kero::RunnerContext::IsShutdownDeadlinePassed() const noexcept -> bool {
+  return shutdown_deadline_ &&
+         std::chrono::steady_clock::now() >= *shutdown_deadline_;
+}
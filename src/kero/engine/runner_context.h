@@ -1,6 +1,8 @@
 #ifndef KERO_ENGINE_RUNNER_CONTEXT_H
 #define KERO_ENGINE_RUNNER_CONTEXT_H
 
+#include <chrono>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -36,7 +38,17 @@ class RunnerContext {
   [[nodiscard]] auto
   GetName() const noexcept -> const std::string&;
 
+  auto
+  RequestShutdown(const u64 timeout_ms) noexcept -> void;
+
+  [[nodiscard]] auto
+  IsShutdownRequested() const noexcept -> bool;
+
+  [[nodiscard]] auto
+  IsShutdownDeadlinePassed() const noexcept -> bool;
+
  private:
+  std::optional<std::chrono::steady_clock::time_point> shutdown_deadline_{};
   ServiceMap service_map_;
   EventHandlerMap event_handler_map_;
   std::string runner_name_;
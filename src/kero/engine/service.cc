@@ -45,6 +45,11 @@ kero::Service::InvokeEvent(const std::string& event,
   return runner_context_->InvokeEvent(event, data);
 }
 
+auto
+kero::Service::RequestShutdown(const u64 timeout_ms) noexcept -> void {
+  runner_context_->RequestShutdown(timeout_ms);
+}
+
 auto
 kero::Service::OnCreate() noexcept -> Result<Void> {
   return OkVoid();
@@ -65,3 +70,13 @@ kero::Service::OnEvent(const std::string& event,
                        const FlatJson& data) noexcept -> void {
   // noop
 }
+
+auto
+kero::Service::OnShutdown() noexcept -> void {
+  // noop
+}
+
+auto
+kero::Service::IsDrained() const noexcept -> bool {
+  return true;
+}
@@ -56,6 +56,13 @@ class Service {
   InvokeEvent(const std::string& event,
               const FlatJson& data) noexcept -> Result<Void>;
 
+  /**
+   * Asks the runner to shut down, see `OnShutdown`. Only the first request of
+   * a runner sets its deadline.
+   */
+  auto
+  RequestShutdown(const u64 timeout_ms) noexcept -> void;
+
   /**
    * Default implementation of the `OnCreate` method is noop.
    */
@@ -80,6 +87,22 @@ class Service {
   virtual auto
   OnEvent(const std::string& event, const FlatJson& data) noexcept -> void;
 
+  /**
+   * Called once when the runner starts shutting down. The runner keeps
+   * updating its services until all of them are drained or the deadline
+   * passes, then destroys them.
+   *
+   * Default implementation of the `OnShutdown` method is noop.
+   */
+  virtual auto
+  OnShutdown() noexcept -> void;
+
+  /**
+   * Default implementation of the `IsDrained` method returns `true`.
+   */
+  [[nodiscard]] virtual auto
+  IsDrained() const noexcept -> bool;
+
  protected:
   DependencyDeclarations dependency_declarations_;
 
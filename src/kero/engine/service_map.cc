@@ -30,6 +30,7 @@ kero::ServiceMap::InvokeCreate() noexcept -> Result<Void> {
       return ResultT::Err(res.TakeErr());
     }
 
+    creation_order_.push_back(service.GetKindId());
     return OkVoid();
   });
 
@@ -58,11 +59,29 @@ kero::ServiceMap::InvokeUpdate() noexcept -> Result<Void> {
   return OkVoid();
 }
 
+auto
+kero::ServiceMap::InvokeShutdown() noexcept -> void {
+  for (const auto service_kind_id : creation_order_) {
+    id_to_service_map_.at(service_kind_id)->OnShutdown();
+  }
+}
+
+auto
+kero::ServiceMap::IsDrained() const noexcept -> bool {
+  return std::all_of(
+      id_to_service_map_.begin(),
+      id_to_service_map_.end(),
+      [](const auto& pair) { return pair.second->IsDrained(); });
+}
+
 auto
 kero::ServiceMap::InvokeDestroy() noexcept -> void {
-  for (auto& [_, service] : id_to_service_map_) {
-    service->OnDestroy();
+  for (auto it = creation_order_.rbegin(); it != creation_order_.rend();
+       ++it) {
+    id_to_service_map_.at(*it)->OnDestroy();
   }
+
+  creation_order_.clear();
   id_to_service_map_.clear();
   name_to_id_map_.clear();
 }
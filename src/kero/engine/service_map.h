@@ -27,6 +27,16 @@ class ServiceMap {
   [[nodiscard]] auto
   InvokeUpdate() noexcept -> Result<Void>;
 
+  auto
+  InvokeShutdown() noexcept -> void;
+
+  [[nodiscard]] auto
+  IsDrained() const noexcept -> bool;
+
+  /**
+   * Services are destroyed in the reverse of their creation order, so each
+   * service can still use its dependencies in `OnDestroy`.
+   */
   auto
   InvokeDestroy() noexcept -> void;
 
@@ -72,6 +82,7 @@ class ServiceMap {
  private:
   IdToServiceMap id_to_service_map_;
   NameToIdMap name_to_id_map_;
+  std::vector<ServiceKindId> creation_order_;
 
   friend class ServiceTraverser;
 };
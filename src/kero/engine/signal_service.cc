@@ -13,7 +13,12 @@ using namespace kero;
 
 kero::SignalService::SignalService(
     const Borrow<RunnerContext> runner_context) noexcept
-    : Service{runner_context, {kServiceKindId_Actor}} {}
+    : SignalService{runner_context, kDefaultShutdownTimeoutMs} {}
+
+kero::SignalService::SignalService(const Borrow<RunnerContext> runner_context,
+                                   const u64 shutdown_timeout_ms) noexcept
+    : Service{runner_context, {kServiceKindId_Actor}},
+      shutdown_timeout_ms_{shutdown_timeout_ms} {}
 
 auto
 kero::SignalService::OnCreate() noexcept -> Result<Void> {
@@ -25,12 +30,17 @@ kero::SignalService::OnCreate() noexcept -> Result<Void> {
     return ResultT::Err(Errno::FromErrno().IntoFlatJson());
   }
 
+  if (signal(SIGTERM, OnSignal) == SIG_ERR) {
+    return ResultT::Err(Errno::FromErrno().IntoFlatJson());
+  }
+
   return OkVoid();
 }
 
 auto
 kero::SignalService::OnDestroy() noexcept -> void {
-  if (signal(SIGINT, SIG_DFL) == SIG_ERR) {
+  if (signal(SIGINT, SIG_DFL) == SIG_ERR ||
+      signal(SIGTERM, SIG_DFL) == SIG_ERR) {
     log::Error("Failed to reset signal handler")
         .Data("errno", Errno::FromErrno())
         .Log();
@@ -39,12 +49,17 @@ kero::SignalService::OnDestroy() noexcept -> void {
 
 auto
 kero::SignalService::OnUpdate() noexcept -> void {
-  if (!interrupted_) {
+  if (!interrupted_ || shutdown_broadcast_) {
     return;
   }
 
+  shutdown_broadcast_ = true;
+  RequestShutdown(shutdown_timeout_ms_);
+
   auto actor = GetDependency<ActorService>();
-  actor->BroadcastMail(EventShutdown::kEvent, FlatJson{});
+  actor->BroadcastMail(
+      EventShutdown::kEvent,
+      FlatJson{}.Set(EventShutdown::kTimeoutMs, shutdown_timeout_ms_).Take());
 }
 
 auto
@@ -56,7 +71,7 @@ std::atomic<bool> SignalService::interrupted_{false};
 
 auto
 kero::SignalService::OnSignal(int signal) noexcept -> void {
-  if (signal == SIGINT) {
+  if (signal == SIGINT || signal == SIGTERM) {
     interrupted_ = true;
   }
   log::Debug("Signal received").Data("signal", signal).Log();
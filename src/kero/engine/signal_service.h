@@ -8,9 +8,17 @@
 
 namespace kero {
 
+/**
+ * On SIGINT or SIGTERM, shuts down its own runner and broadcasts
+ * `EventShutdown` once so every other runner follows.
+ */
 class SignalService final : public Service {
  public:
   explicit SignalService(const Borrow<RunnerContext> runner_context) noexcept;
+
+  explicit SignalService(const Borrow<RunnerContext> runner_context,
+                         const u64 shutdown_timeout_ms) noexcept;
+
   virtual ~SignalService() noexcept override = default;
   KERO_CLASS_KIND_MOVABLE(SignalService);
   KERO_SERVICE_KIND(kServiceKindId_Signal, "signal");
@@ -27,10 +35,15 @@ class SignalService final : public Service {
   [[nodiscard]] auto
   IsInterrupted() const noexcept -> bool;
 
+  static constexpr u64 kDefaultShutdownTimeoutMs{10000};
+
  private:
   static auto
   OnSignal(int signal) noexcept -> void;
 
+  u64 shutdown_timeout_ms_{kDefaultShutdownTimeoutMs};
+  bool shutdown_broadcast_{false};
+
   static std::atomic<bool> interrupted_;
 };
 
@@ -1,5 +1,6 @@
 #include "center.h"
 
+#include "crash_handler.h"
 #include "global_context.h"
 
 using namespace kero;
@@ -19,3 +20,19 @@ auto
 kero::Center::AddTransport(Own<Transport>&& transport) noexcept -> void {
   GetGlobalContext().AddTransport(std::move(transport));
 }
+
+auto
+kero::Center::SetLogQueueOptions(const LogQueueOptions options) noexcept
+    -> void {
+  GetGlobalContext().SetLogQueueOptions(options);
+}
+
+auto
+kero::Center::GetLogDropStats() const noexcept -> LogDropStats {
+  return GetGlobalContext().GetLogDropStats();
+}
+
+auto
+kero::Center::InstallCrashHandler(const int fd) noexcept -> Result<Void> {
+  return kero::InstallCrashHandler(fd);
+}
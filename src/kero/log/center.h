@@ -4,6 +4,8 @@
 #include <iostream>
 #include <memory>
 
+#include "kero/core/result.h"
+#include "log_queue.h"
 #include "transport.h"
 
 namespace kero {
@@ -23,6 +25,25 @@ class Center final {
 
   auto
   AddTransport(Own<Transport>&& transport) noexcept -> void;
+
+  /**
+   * Applies to the queues of threads which log for the first time after, so
+   * it should be set before any thread logs.
+   */
+  auto
+  SetLogQueueOptions(const LogQueueOptions options) noexcept -> void;
+
+  /**
+   * See `InstallCrashHandler`.
+   */
+  [[nodiscard]] auto
+  InstallCrashHandler(const int fd = 2) noexcept -> Result<Void>;
+
+  /**
+   * Records dropped by each thread since it started, per level.
+   */
+  [[nodiscard]] auto
+  GetLogDropStats() const noexcept -> LogDropStats;
 };
 
 }  // namespace kero
@@ -18,12 +18,29 @@ kero::LevelToString(const Level level) noexcept -> std::string {
   }
 }
 
+auto
+kero::SteadyToSystemTime(
+    const std::chrono::steady_clock::time_point time_point) noexcept
+    -> std::chrono::system_clock::time_point {
+  using namespace std::chrono;
+
+  static const auto offset =
+      system_clock::now().time_since_epoch() -
+      duration_cast<system_clock::duration>(
+          steady_clock::now().time_since_epoch());
+  return system_clock::time_point{
+      duration_cast<system_clock::duration>(time_point.time_since_epoch()) +
+      offset};
+}
+
 kero::Log::Log(std::string&& message,
                std::source_location&& location,
-               const Level level) noexcept
+               const Level level,
+               const std::chrono::system_clock::time_point timestamp) noexcept
     : message(std::move(message)),
       location(std::move(location)),
-      level(level) {}
+      level(level),
+      timestamp(timestamp) {}
 
 kero::ShutdownConfig::ShutdownConfig() noexcept
     : timeout{std::chrono::milliseconds{1000}} {}
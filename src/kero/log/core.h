@@ -8,6 +8,10 @@
 
 #include "kero/core/common.h"
 
+#ifndef KERO_LOG_MIN_LEVEL
+#define KERO_LOG_MIN_LEVEL 30
+#endif
+
 namespace kero {
 
 enum class Level : i8 {
@@ -17,18 +21,57 @@ enum class Level : i8 {
   kDebug = 30,
 };
 
+/**
+ * Logs less severe than `KERO_LOG_MIN_LEVEL` are compiled out, their builders
+ * do nothing. Their `Data` arguments are still evaluated, unless the log is
+ * written with `KERO_LOG_DEBUG` or the other macros of `log_builder.h`.
+ */
+inline constexpr Level kCompiledLevel{
+    static_cast<Level>(KERO_LOG_MIN_LEVEL)};
+
 [[nodiscard]] auto
 LevelToString(const Level level) noexcept -> std::string;
 
+inline constexpr size_t kLevelCount{4};
+
+/**
+ * Maps a level to `[0, kLevelCount)`, for counters kept per level.
+ */
+[[nodiscard]] constexpr auto
+LevelToIndex(const Level level) noexcept -> size_t {
+  const auto index = static_cast<size_t>(level) / 10;
+  return index < kLevelCount ? index : kLevelCount - 1;
+}
+
+/**
+ * Converts a `steady_clock` time to wall clock time. The offset between the
+ * clocks is measured once, on the first call.
+ */
+[[nodiscard]] auto
+SteadyToSystemTime(const std::chrono::steady_clock::time_point time_point)
+    noexcept -> std::chrono::system_clock::time_point;
+
 struct Log final {
   std::unordered_map<std::string, std::string> data;
   std::string message;
   std::source_location location;
   Level level;
 
+  /**
+   * When the log was built, not when it is written.
+   */
+  std::chrono::system_clock::time_point timestamp;
+
+  /**
+   * The ordinal of the thread which logged, 0 for logs of the log system.
+   */
+  u16 thread_ordinal{};
+
   explicit Log(std::string&& message,
                std::source_location&& location,
-               const Level level) noexcept;
+               const Level level,
+               const std::chrono::system_clock::time_point timestamp =
+                   std::chrono::system_clock::now()) noexcept;
   ~Log() noexcept = default;
   KERO_CLASS_KIND_MOVABLE(Log);
 };
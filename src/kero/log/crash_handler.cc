@@ -0,0 +1,272 @@
+#include "crash_handler.h"
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+#include "kero/core/utils.h"
+#include "kero/core/utils_linux.h"
+#include "kero/log/global_context.h"
+#include "kero/log/log_record.h"
+
+using namespace kero;
+
+namespace {
+
+constexpr int kFatalSignals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGILL, SIGFPE};
+
+/**
+ * Appends to a fixed buffer, cutting what does not fit. Async-signal-safe.
+ */
+class CrashWriter final {
+ public:
+  explicit CrashWriter(char* const data, const size_t capacity) noexcept
+      : data_{data}, capacity_{capacity} {}
+
+  auto
+  Append(const std::string_view str) noexcept -> CrashWriter& {
+    const auto size = std::min(str.size(), capacity_ - size_);
+    std::copy_n(str.data(), size, data_ + size_);
+    size_ += size;
+    return *this;
+  }
+
+  template <typename T>
+  auto
+  AppendNumber(const T value) noexcept -> CrashWriter& {
+    char digits[32];
+    const auto [end, _] =
+        std::to_chars(std::begin(digits), std::end(digits), value);
+    return Append(std::string_view{digits, static_cast<size_t>(end - digits)});
+  }
+
+  /**
+   * Zero-padded to `width` digits.
+   */
+  auto
+  AppendPadded(u64 value, const size_t width) noexcept -> CrashWriter& {
+    char digits[20];
+    for (size_t i = width; i > 0; --i, value /= 10) {
+      digits[i - 1] = static_cast<char>('0' + value % 10);
+    }
+
+    return Append(std::string_view{digits, width});
+  }
+
+  auto
+  Flush(const int fd) noexcept -> void {
+    size_t written{0};
+    while (written < size_) {
+      const auto res = ::write(fd, data_ + written, size_ - written);
+      if (res <= 0) {
+        break;
+      }
+
+      written += static_cast<size_t>(res);
+    }
+
+    size_ = 0;
+  }
+
+ private:
+  char* data_;
+  size_t capacity_;
+  size_t size_{};
+};
+
+/**
+ * `gmtime_r` is not async-signal-safe, so the date is computed by hand.
+ */
+auto
+AppendUtc(CrashWriter& writer,
+          const std::chrono::system_clock::time_point time_point) noexcept
+    -> void {
+  using namespace std::chrono;
+
+  const auto micros =
+      duration_cast<microseconds>(time_point.time_since_epoch()).count();
+  const auto days = floor<std::chrono::days>(sys_time<microseconds>{
+      microseconds{micros}});
+  const year_month_day date{days};
+  const hh_mm_ss time{microseconds{micros} - days.time_since_epoch()};
+
+  writer.AppendPadded(static_cast<u64>(static_cast<int>(date.year())), 4)
+      .Append("-")
+      .AppendPadded(static_cast<unsigned>(date.month()), 2)
+      .Append("-")
+      .AppendPadded(static_cast<unsigned>(date.day()), 2)
+      .Append("T")
+      .AppendPadded(time.hours().count(), 2)
+      .Append(":")
+      .AppendPadded(time.minutes().count(), 2)
+      .Append(":")
+      .AppendPadded(time.seconds().count(), 2)
+      .Append(".")
+      .AppendPadded(time.subseconds().count(), 6)
+      .Append("Z");
+}
+
+auto
+LevelName(const Level level) noexcept -> std::string_view {
+  switch (level) {
+    case Level::kError:
+      return "ERROR";
+    case Level::kWarn:
+      return "WARN";
+    case Level::kInfo:
+      return "INFO";
+    case Level::kDebug:
+      return "DEBUG";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+/**
+ * Reads text bounded by the record, which may be half overwritten.
+ */
+auto
+GetTextBounded(const LogRecord& record, const LogText text) noexcept
+    -> std::string_view {
+  const auto offset = std::min<size_t>(text.offset, record.text.size());
+  const auto size = std::min<size_t>(text.size, record.text.size() - offset);
+  return std::string_view{record.text.data() + offset, size};
+}
+
+auto
+AppendRecord(CrashWriter& writer, const LogRecord& record) noexcept -> void {
+  AppendUtc(writer, SteadyToSystemTime(record.timestamp));
+  writer.Append(" ")
+      .Append(LevelName(record.level))
+      .Append(" [thread ")
+      .AppendNumber(record.thread_ordinal)
+      .Append("] ")
+      .Append(GetTextBounded(record, record.message));
+
+  const auto field_count =
+      std::min<size_t>(record.field_count, LogRecord::kMaxFieldCount);
+  for (size_t i = 0; i < field_count; ++i) {
+    const auto& field = record.fields[i];
+    writer.Append(" ").Append(field.key ? field.key : "?").Append("=");
+    std::visit(
+        [&writer, &record](const auto& value) {
+          using T = std::decay_t<decltype(value)>;
+
+          if constexpr (std::is_same_v<T, LogText>) {
+            writer.Append(GetTextBounded(record, value));
+          } else if constexpr (std::is_same_v<T, bool>) {
+            writer.Append(value ? "true" : "false");
+          } else {
+            writer.AppendNumber(value);
+          }
+        },
+        field.value);
+  }
+
+  if (const auto* const file_name = record.location.file_name()) {
+    writer.Append(" (")
+        .Append(file_name)
+        .Append(":")
+        .AppendNumber(record.location.line())
+        .Append(")");
+  }
+
+  writer.Append("\n");
+}
+
+int crash_fd{STDERR_FILENO};
+/**
+ * The thread which writes the logs, zero until a thread crashes.
+ */
+std::atomic<pid_t> crashing_tid{0};
+
+// Preallocated, the handler must not allocate.
+alignas(64) char crash_buffer[LogRecord::kTextCapacity + 4096];
+alignas(64) char crash_stack[64 * 1024];
+
+/**
+ * Async-signal-safe, so the handler may restore the default actions.
+ */
+auto
+ResetFatalSignals() noexcept -> void {
+  struct sigaction action {};
+  action.sa_handler = SIG_DFL;
+  sigemptyset(&action.sa_mask);
+  for (const auto signal : kFatalSignals) {
+    std::ignore = ::sigaction(signal, &action, nullptr);
+  }
+}
+
+auto
+OnFatalSignal(const int signal) noexcept -> void {
+  // The handlers stay installed, so a second crashing thread comes here too
+  // and waits for the first to take the process down. A crash while writing
+  // the logs comes back on the same thread, which must not wait for itself.
+  const auto tid = ::gettid();
+  if (pid_t expected{0};
+      !crashing_tid.compare_exchange_strong(expected, tid)) {
+    if (expected == tid) {
+      ResetFatalSignals();
+      ::raise(signal);
+    }
+
+    while (true) {
+      ::pause();
+    }
+  }
+
+  CrashWriter writer{crash_buffer, sizeof(crash_buffer)};
+  writer.Append("Fatal signal ")
+      .AppendNumber(signal)
+      .Append(", writing queued logs\n")
+      .Flush(crash_fd);
+
+  GetGlobalContext().VisitQueuedRecordsUnsynchronized(
+      [&writer](const LogRecord& record) noexcept {
+        AppendRecord(writer, record);
+        writer.Flush(crash_fd);
+      });
+
+  writer.Append("Queued logs written\n").Flush(crash_fd);
+
+  ResetFatalSignals();
+  ::raise(signal);
+}
+
+}  // namespace
+
+auto
+kero::InstallCrashHandler(const int fd) noexcept -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  // Both initialize statics here, so the handler never does.
+  std::ignore = GetGlobalContext();
+  std::ignore = SteadyToSystemTime(std::chrono::steady_clock::now());
+  crash_fd = fd;
+
+  stack_t stack{};
+  stack.ss_sp = crash_stack;
+  stack.ss_size = sizeof(crash_stack);
+  if (::sigaltstack(&stack, nullptr) == -1) {
+    return ResultT::Err(Errno::FromErrno().IntoFlatJson());
+  }
+
+  struct sigaction action {};
+  action.sa_handler = OnFatalSignal;
+  action.sa_flags = SA_NODEFER | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+  for (const auto signal : kFatalSignals) {
+    if (::sigaction(signal, &action, nullptr) == -1) {
+      return ResultT::Err(Errno::FromErrno().IntoFlatJson());
+    }
+  }
+
+  return OkVoid();
+}
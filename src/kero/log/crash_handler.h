@@ -0,0 +1,26 @@
+#ifndef KERO_LOG_CRASH_HANDLER_H
+#define KERO_LOG_CRASH_HANDLER_H
+
+#include "kero/core/result.h"
+
+namespace kero {
+
+/**
+ * Installs handlers for SIGSEGV, SIGABRT, SIGBUS, SIGILL and SIGFPE which
+ * write the records still queued by every thread to `fd`, then let the
+ * signal kill the process as it would have.
+ *
+ * The handler only formats into preallocated memory and calls `write`.
+ * Records are read while other threads may still run, so a record being
+ * queued or drained at that moment may come out garbled. Logs the log
+ * thread already took but has not written yet are lost. Only the calling
+ * thread gets an alternate signal stack, so a stack overflow on another
+ * thread may not reach the handler. Other threads which crash meanwhile wait
+ * for the first to finish writing.
+ */
+[[nodiscard]] auto
+InstallCrashHandler(const int fd) noexcept -> Result<Void>;
+
+}  // namespace kero
+
+#endif  // KERO_LOG_CRASH_HANDLER_H
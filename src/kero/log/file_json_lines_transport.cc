@@ -0,0 +1,269 @@
+#include "file_json_lines_transport.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+
+#include "kero/core/flat_json_parser.h"
+#include "kero/core/utils_linux.h"
+
+using namespace kero;
+
+auto
+kero::AppendJsonLine(std::string& buffer,
+                     const Log& log,
+                     Iso8601Cache& timestamp_cache) noexcept -> void {
+  buffer += "{\"time\":\"";
+  timestamp_cache.Append(buffer, log.timestamp);
+  buffer += "\",\"level\":\"";
+  buffer += LevelToString(log.level);
+  buffer += "\",\"thread\":";
+  AppendNumber(buffer, log.thread_ordinal);
+  buffer += ",\"message\":\"";
+  AppendJsonEscaped(buffer, log.message);
+  buffer += '"';
+
+  if (!log.data.empty()) {
+    buffer += ",\"data\":{";
+    bool is_first{true};
+    for (const auto& [key, value] : log.data) {
+      if (!is_first) {
+        buffer += ',';
+      }
+
+      is_first = false;
+      buffer += '"';
+      AppendJsonEscaped(buffer, key);
+      buffer += "\":\"";
+      AppendJsonEscaped(buffer, value);
+      buffer += '"';
+    }
+    buffer += '}';
+  }
+
+  if (log.location.file_name() != nullptr) {
+    buffer += ",\"location\":\"";
+    AppendJsonEscaped(buffer, log.location.file_name());
+    buffer += ':';
+    AppendNumber(buffer, log.location.line());
+    buffer += ':';
+    AppendNumber(buffer, log.location.column());
+    buffer += '"';
+  }
+
+  if (log.location.function_name() != nullptr) {
+    buffer += ",\"function\":\"";
+    AppendJsonEscaped(buffer, log.location.function_name());
+    buffer += '"';
+  }
+
+  buffer += "}\n";
+}
+
+auto
+kero::FileJsonLinesTransport::Builder::Build(
+    FileJsonLinesOptions&& options) const noexcept
+    -> Result<Own<FileJsonLinesTransport>> {
+  using ResultT = Result<Own<FileJsonLinesTransport>>;
+
+  if (options.path.empty()) {
+    return ResultT::Err(Error::From(
+        FlatJson{}
+            .Set("message", std::string{"Log file path must not be empty"})
+            .Take()));
+  }
+
+  Own<FileJsonLinesTransport> transport{
+      new FileJsonLinesTransport{std::move(options)}};
+  if (!transport->OpenFile()) {
+    return ResultT::Err(Error::From(
+        Errno::FromErrno()
+            .IntoFlatJson()
+            .Set("message", std::string{"Failed to open log file"})
+            .Set("path", transport->options_.path)
+            .Take()));
+  }
+
+  if (transport->options_.use_async_sync) {
+    transport->sync_thread_ =
+        std::thread{&FileJsonLinesTransport::RunSync, transport.get()};
+  }
+
+  return ResultT{std::move(transport)};
+}
+
+kero::FileJsonLinesTransport::FileJsonLinesTransport(
+    FileJsonLinesOptions&& options) noexcept
+    : options_{std::move(options)} {
+  buffer_.reserve(kFlushThreshold * 2);
+}
+
+kero::FileJsonLinesTransport::~FileJsonLinesTransport() noexcept {
+  OnFlush();
+
+  // The sync thread syncs and closes the file before it stops.
+  CloseFile();
+
+  if (sync_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      is_stopping_ = true;
+    }
+
+    sync_cv_.notify_one();
+    sync_thread_.join();
+  }
+}
+
+auto
+kero::FileJsonLinesTransport::OnLog(const Log& log) noexcept -> void {
+  AppendJsonLine(buffer_, log, timestamp_cache_);
+  if (buffer_.size() >= kFlushThreshold) {
+    OnFlush();
+  }
+}
+
+auto
+kero::FileJsonLinesTransport::OnFlush() noexcept -> void {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  if (fd_ >= 0 && ShouldRotate()) {
+    Rotate();
+  }
+
+  if (fd_ < 0 && !OpenFile()) {
+    buffer_.clear();
+    return;
+  }
+
+  if (WriteAll(fd_, buffer_)) {
+    file_size_ += buffer_.size();
+  }
+
+  buffer_.clear();
+
+  if (sync_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      sync_fd_ = fd_;
+    }
+
+    sync_cv_.notify_one();
+  }
+}
+
+auto
+kero::FileJsonLinesTransport::OpenFile() noexcept -> bool {
+  const auto fd = ::open(options_.path.c_str(),
+                         O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                         0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat file_stat {};
+  file_size_ = ::fstat(fd, &file_stat) == 0
+                   ? static_cast<size_t>(file_stat.st_size)
+                   : 0;
+  file_opened_at_ = std::chrono::steady_clock::now();
+  fd_ = fd;
+  return true;
+}
+
+auto
+kero::FileJsonLinesTransport::CloseFile() noexcept -> void {
+  if (fd_ < 0) {
+    return;
+  }
+
+  const auto fd = std::exchange(fd_, -1);
+  if (!sync_thread_.joinable()) {
+    ::close(fd);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    if (sync_fd_ == fd) {
+      sync_fd_ = -1;
+    }
+
+    closing_fds_.push_back(fd);
+  }
+
+  sync_cv_.notify_one();
+}
+
+auto
+kero::FileJsonLinesTransport::ShouldRotate() const noexcept -> bool {
+  if (file_size_ == 0) {
+    return false;
+  }
+
+  if (file_size_ + buffer_.size() > options_.max_file_size) {
+    return true;
+  }
+
+  return options_.max_file_age.count() > 0 &&
+         std::chrono::steady_clock::now() - file_opened_at_ >=
+             options_.max_file_age;
+}
+
+auto
+kero::FileJsonLinesTransport::Rotate() noexcept -> void {
+  CloseFile();
+
+  const auto& path = options_.path;
+  if (options_.max_backup_count == 0) {
+    ::unlink(path.c_str());
+    return;
+  }
+
+  // Shifts path.N-1 to path.N, ..., path to path.1, replacing the oldest.
+  for (auto i = options_.max_backup_count; i > 1; --i) {
+    const auto from = path + "." + std::to_string(i - 1);
+    const auto to = path + "." + std::to_string(i);
+    std::ignore = std::rename(from.c_str(), to.c_str());
+  }
+
+  std::ignore = std::rename(path.c_str(), (path + ".1").c_str());
+}
+
+auto
+kero::FileJsonLinesTransport::RunSync() noexcept -> void {
+  std::vector<int> closing_fds{};
+  while (true) {
+    int sync_fd{-1};
+    {
+      std::unique_lock<std::mutex> lock(sync_mutex_);
+      sync_cv_.wait(lock, [this] {
+        return sync_fd_ >= 0 || !closing_fds_.empty() || is_stopping_;
+      });
+      if (sync_fd_ < 0 && closing_fds_.empty()) {
+        return;
+      }
+
+      sync_fd = std::exchange(sync_fd_, -1);
+      closing_fds.swap(closing_fds_);
+    }
+
+    // Only this thread closes files once it runs, so `sync_fd` stays open.
+    if (sync_fd >= 0) {
+      std::ignore = ::fdatasync(sync_fd);
+    }
+
+    for (const auto fd : closing_fds) {
+      std::ignore = ::fdatasync(fd);
+      ::close(fd);
+    }
+
+    closing_fds.clear();
+  }
+}
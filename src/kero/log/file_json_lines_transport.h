@@ -0,0 +1,124 @@
+#ifndef KERO_LOG_FILE_JSON_LINES_TRANSPORT_H
+#define KERO_LOG_FILE_JSON_LINES_TRANSPORT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kero/core/result.h"
+#include "kero/log/core.h"
+#include "kero/log/transport.h"
+#include "kero/log/utils.h"
+
+namespace kero {
+
+struct FileJsonLinesOptions final {
+  std::string path{};
+
+  /**
+   * The file is rotated before a write would grow it past this size.
+   */
+  size_t max_file_size{64 * 1024 * 1024};
+
+  /**
+   * The file is rotated once it is this old, zero disables it.
+   */
+  std::chrono::seconds max_file_age{0};
+
+  /**
+   * Rotated files are kept as `path.1` (newest) to `path.N`.
+   */
+  u32 max_backup_count{5};
+
+  /**
+   * Syncs the file with `fdatasync` on a background thread after each
+   * batch, so the log thread never waits for the disk. Rotated files are
+   * synced and closed on that thread too.
+   */
+  bool use_async_sync{false};
+};
+
+/**
+ * Appends `log` as one JSON object and a newline.
+ */
+auto
+AppendJsonLine(std::string& buffer,
+               const Log& log,
+               Iso8601Cache& timestamp_cache) noexcept -> void;
+
+/**
+ * Writes each log as one JSON object per line to a file opened with
+ * `O_APPEND`, buffering a batch into a single write like
+ * `BufferedPlainTextTransport`.
+ *
+ * Write errors drop the buffered logs, and a file which fails to open is
+ * opened again on the next batch. Reporting either would log again.
+ */
+class FileJsonLinesTransport : public Transport {
+ public:
+  class Builder {
+   public:
+    Builder() noexcept = default;
+    ~Builder() noexcept = default;
+    KERO_CLASS_KIND_PINNABLE(Builder);
+
+    [[nodiscard]] auto
+    Build(FileJsonLinesOptions&& options) const noexcept
+        -> Result<Own<FileJsonLinesTransport>>;
+  };
+
+  virtual ~FileJsonLinesTransport() noexcept;
+  KERO_CLASS_KIND_PINNABLE(FileJsonLinesTransport);
+
+  virtual auto
+  OnLog(const Log& log) noexcept -> void override;
+
+  virtual auto
+  OnFlush() noexcept -> void override;
+
+  static constexpr size_t kFlushThreshold{
+      BufferedPlainTextTransport::kFlushThreshold};
+
+ private:
+  explicit FileJsonLinesTransport(FileJsonLinesOptions&& options) noexcept;
+
+  [[nodiscard]] auto
+  OpenFile() noexcept -> bool;
+
+  auto
+  CloseFile() noexcept -> void;
+
+  [[nodiscard]] auto
+  ShouldRotate() const noexcept -> bool;
+
+  auto
+  Rotate() noexcept -> void;
+
+  auto
+  RunSync() noexcept -> void;
+
+  FileJsonLinesOptions options_;
+  std::string buffer_{};
+  Iso8601Cache timestamp_cache_{};
+  size_t file_size_{};
+  std::chrono::steady_clock::time_point file_opened_at_{};
+
+  int fd_{-1};
+
+  /**
+   * Hand files to the sync thread, which owns closing them while it runs.
+   */
+  std::mutex sync_mutex_{};
+  std::condition_variable sync_cv_{};
+  int sync_fd_{-1};
+  std::vector<int> closing_fds_{};
+  bool is_stopping_{false};
+  std::thread sync_thread_{};
+};
+
+}  // namespace kero
+
+#endif  // KERO_LOG_FILE_JSON_LINES_TRANSPORT_H
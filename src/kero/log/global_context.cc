@@ -1,9 +1,13 @@
 #include "global_context.h"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <optional>
+#include <thread>
 
 #include "kero/log/core.h"
+#include "kero/log/rate_limiter.h"
 #include "kero/log/runner_event.h"
 #include "kero/log/transport.h"
 
@@ -42,81 +46,229 @@ kero::GlobalContext::LogSystemError(std::string&& message) noexcept -> void {
 }
 
 auto
-kero::GlobalContext::AddLogRx(const std::string& thread_id,
-                              spsc::Rx<Own<kero::Log>>&& log_rx) noexcept
-    -> bool {
+kero::GlobalContext::AddLogQueue(const Share<LogQueue>& log_queue) noexcept
+    -> std::optional<u16> {
   std::lock_guard<std::mutex> lock(shared_state_mutex_);
-  if (shared_state_.log_rx_map.find(thread_id) !=
-      shared_state_.log_rx_map.end()) {
-    return false;
+  for (size_t i = 0; i < log_slots_.size(); ++i) {
+    auto& log_slot = log_slots_[i];
+    if (log_slot.state.load(std::memory_order_acquire) !=
+        LogSlotState::kFree) {
+      continue;
+    }
+
+    log_slot.log_queue = log_queue;
+    log_slot.state.store(LogSlotState::kLive, std::memory_order_release);
+    if (i + 1 > log_slot_end_.load(std::memory_order_relaxed)) {
+      log_slot_end_.store(i + 1, std::memory_order_release);
+    }
+
+    return static_cast<u16>(i + 1);
   }
 
-  shared_state_.log_rx_map.emplace(thread_id, std::move(log_rx));
-  return true;
+  return std::nullopt;
 }
 
 auto
-kero::GlobalContext::RemoveLogRx(const std::string& thread_id) noexcept
+kero::GlobalContext::RemoveLogQueue(const u16 thread_ordinal) noexcept
     -> bool {
-  std::lock_guard<std::mutex> lock(shared_state_mutex_);
-  auto entry = shared_state_.log_rx_map.find(thread_id);
-  if (entry == shared_state_.log_rx_map.end()) {
-    return false;
-  }
+  {
+    std::lock_guard<std::mutex> lock(shared_state_mutex_);
+    if (thread_ordinal == 0 || thread_ordinal > log_slots_.size()) {
+      return false;
+    }
+
+    auto& log_slot = log_slots_[thread_ordinal - 1];
+    if (log_slot.state.load(std::memory_order_acquire) !=
+        LogSlotState::kLive) {
+      return false;
+    }
 
-  while (auto log = entry->second.TryReceive()) {
-    shared_state_.orphaned_logs.push_back(std::move(log.TakeUnwrap()));
+    // The thread is exiting, so its drop counts are final.
+    const auto drop_counts = log_slot.log_queue->GetDropCounts();
+    for (size_t i = 0; i < kLevelCount; ++i) {
+      shared_state_.exited_drop_counts[i] += drop_counts[i];
+    }
+
+    log_slot.state.store(LogSlotState::kExited, std::memory_order_release);
   }
 
-  shared_state_.log_rx_map.erase(thread_id);
+  // Lets a parked log thread drain and free the slot.
+  NotifyLog();
   return true;
 }
 
+auto
+kero::GlobalContext::SetLogQueueOptions(const LogQueueOptions options) noexcept
+    -> void {
+  std::lock_guard<std::mutex> lock(shared_state_mutex_);
+  shared_state_.log_queue_options = options;
+}
+
+auto
+kero::GlobalContext::GetLogQueueOptions() const noexcept -> LogQueueOptions {
+  std::lock_guard<std::mutex> lock(shared_state_mutex_);
+  return shared_state_.log_queue_options;
+}
+
+auto
+kero::GlobalContext::GetLogDropStats() const noexcept -> LogDropStats {
+  std::lock_guard<std::mutex> lock(shared_state_mutex_);
+  LogDropStats stats{.exited_drop_counts = shared_state_.exited_drop_counts};
+  const auto end = log_slot_end_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < end; ++i) {
+    const auto& log_slot = log_slots_[i];
+    if (log_slot.state.load(std::memory_order_acquire) !=
+        LogSlotState::kLive) {
+      continue;
+    }
+
+    stats.threads.push_back(LogDropStats::Thread{
+        .thread_ordinal = static_cast<u16>(i + 1),
+        .drop_counts = log_slot.log_queue->GetDropCounts()});
+  }
+
+  return stats;
+}
+
 auto
 kero::GlobalContext::Shutdown(ShutdownConfig&& config) noexcept -> void {
   runner_event_tx_.Send(
       std::make_unique<RunnerEvent>(runner_event::Shutdown{std::move(config)}));
+  Wake();
   runner_thread_.join();
+  stopped_.store(true, std::memory_order_release);
 }
 
 auto
 kero::GlobalContext::AddTransport(Own<Transport>&& transport) noexcept -> void {
   std::lock_guard<std::mutex> lock(shared_state_mutex_);
   shared_state_.transports.push_back(std::move(transport));
+
+  auto level = Level::kError;
+  for (const auto& added : shared_state_.transports) {
+    level = std::max(level, added->GetLevel());
+  }
+
+  level_.store(level, std::memory_order_relaxed);
 }
 
+// Indexed by `LevelToIndex`.
+static constexpr std::array<const char*, kLevelCount> kDroppedKeys{
+    "dropped_error", "dropped_warn", "dropped_info", "dropped_debug"};
+
 auto
-kero::GlobalContext::TryPopLog() noexcept -> Option<Own<kero::Log>> {
-  std::lock_guard<std::mutex> lock(shared_state_mutex_);
+kero::GlobalContext::DrainLogs() noexcept -> size_t {
+  // Formatting may log a system error, which takes the lock, so the batch is
+  // formatted first and handed to the transports under a single lock.
+  const auto end = log_slot_end_.load(std::memory_order_acquire);
+  for (size_t slot_index = 0; slot_index < end; ++slot_index) {
+    auto& log_slot = log_slots_[slot_index];
+    const auto state = log_slot.state.load(std::memory_order_acquire);
+    if (state == LogSlotState::kFree) {
+      continue;
+    }
 
-  if (!shared_state_.orphaned_logs.empty()) {
-    auto log = std::move(shared_state_.orphaned_logs.front());
-    shared_state_.orphaned_logs.pop_front();
-    return log;
-  }
+    const auto thread_ordinal = static_cast<u16>(slot_index + 1);
+    auto& log_queue = *log_slot.log_queue;
+    if (const auto drop_counts = log_queue.GetDropCounts();
+        drop_counts != log_slot.reported_drop_counts) {
+      auto log = std::make_unique<kero::Log>("Log queue full, logs dropped",
+                                             std::source_location::current(),
+                                             Level::kWarn);
+      log->data.emplace("thread_ordinal", std::to_string(thread_ordinal));
+      for (size_t i = 0; i < kLevelCount; ++i) {
+        const auto count = drop_counts[i] - log_slot.reported_drop_counts[i];
+        if (count > 0) {
+          log->data.emplace(kDroppedKeys[i], std::to_string(count));
+        }
+      }
 
-  for (const auto& [thread_id, log_rx] : shared_state_.log_rx_map) {
-    auto log = log_rx.TryReceive();
-    if (!log) {
-      continue;
+      drained_logs_.push_back(std::move(log));
+      log_slot.reported_drop_counts = drop_counts;
+    }
+
+    for (size_t i = 0; i < kDrainBatchSize; ++i) {
+      const auto popped =
+          log_queue.PopWith([this](const LogRecord& record) noexcept {
+            drained_logs_.push_back(LogRecordToLog(record));
+          });
+      if (!popped) {
+        break;
+      }
+    }
+
+    // The thread is gone, so nothing is pushed after the queue is empty.
+    if (state == LogSlotState::kExited && log_queue.IsEmpty()) {
+      FreeLogSlot(log_slot);
     }
+  }
+
+  const auto count = drained_logs_.size();
+  if (count > 0) {
+    HandleLogs(drained_logs_);
+    drained_logs_.clear();
+  }
+
+  return count;
+}
 
-    return log.TakeUnwrap();
+auto
+kero::GlobalContext::Park(const u32 wake_epoch) noexcept -> void {
+  parked_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (HasPendingLogs()) {
+    parked_.store(false, std::memory_order_relaxed);
+    return;
   }
 
-  return None;
+  wake_epoch_.wait(wake_epoch, std::memory_order_acquire);
+  parked_.store(false, std::memory_order_relaxed);
 }
 
 auto
-kero::GlobalContext::HandleLog(const kero::Log& log) const noexcept -> void {
+kero::GlobalContext::FreeLogSlot(LogSlot& log_slot) noexcept -> void {
   std::lock_guard<std::mutex> lock(shared_state_mutex_);
+  log_slot.log_queue.reset();
+  log_slot.reported_drop_counts = LogDropCounts{};
+  log_slot.state.store(LogSlotState::kFree, std::memory_order_release);
+}
 
-  for (auto& transport : shared_state_.transports) {
-    if (log.level > transport->GetLevel()) {
-      continue;
+auto
+kero::GlobalContext::HasPendingLogs() const noexcept -> bool {
+  const auto end = log_slot_end_.load(std::memory_order_acquire);
+  return std::any_of(
+      log_slots_.begin(),
+      log_slots_.begin() + end,
+      [](const LogSlot& log_slot) {
+        const auto state = log_slot.state.load(std::memory_order_acquire);
+        if (state == LogSlotState::kFree) {
+          return false;
+        }
+
+        return state == LogSlotState::kExited ||
+               !log_slot.log_queue->IsEmpty() ||
+               log_slot.log_queue->GetDropCounts() !=
+                   log_slot.reported_drop_counts;
+      });
+}
+
+auto
+kero::GlobalContext::HandleLogs(
+    const std::vector<Own<kero::Log>>& logs) const noexcept -> void {
+  std::lock_guard<std::mutex> lock(shared_state_mutex_);
+
+  for (const auto& log : logs) {
+    for (auto& transport : shared_state_.transports) {
+      if (log->level > transport->GetLevel()) {
+        continue;
+      }
+
+      transport->OnLog(*log);
     }
+  }
 
-    transport->OnLog(log);
+  for (auto& transport : shared_state_.transports) {
+    transport->OnFlush();
   }
 }
 
@@ -131,56 +283,80 @@ kero::GetGlobalContext() -> GlobalContext& {
 
 auto
 kero::RunOnThread(mpsc::Rx<Own<RunnerEvent>>&& runner_event_rx) -> void {
+  auto& global_context = GetGlobalContext();
   std::optional<std::chrono::steady_clock::time_point> shutdown_deadline{};
+  u32 idle_pass_count{};
 
   while (true) {
-    auto event_opt = runner_event_rx.TryReceive();
-    auto log_opt = GetGlobalContext().TryPopLog();
-    if (shutdown_deadline) {
-      if (std::chrono::steady_clock::now() > *shutdown_deadline) {
-        break;
+    // Read before looking for work, so a wake after this point is not lost.
+    const auto wake_epoch = GlobalContext::GetWakeEpoch();
+
+    while (auto event_opt = runner_event_rx.TryReceive()) {
+      auto event = event_opt.TakeUnwrap();
+      if (!event) {
+        global_context.LogSystemError("Internal: *event must not be null.");
+        continue;
       }
 
-      if (!event_opt && !log_opt) {
+      std::visit(
+          [&global_context, &shutdown_deadline](auto&& event) {
+            using T = std::decay_t<decltype(event)>;
+
+            if constexpr (std::is_same_v<T, runner_event::Shutdown>) {
+              if (shutdown_deadline) {
+                global_context.LogSystemError("Shutdown already scheduled.");
+                return;
+              }
+
+              runner_event::Shutdown& shutdown = event;
+              shutdown_deadline =
+                  std::chrono::steady_clock::now() + shutdown.config.timeout;
+            } else {
+              static_assert(always_false_v<T>,
+                            "every RunnerEvent must be handled.");
+            }
+          },
+          *event);
+    }
+
+    const auto count = global_context.DrainLogs();
+    if (shutdown_deadline) {
+      if (count == 0 ||
+          std::chrono::steady_clock::now() > *shutdown_deadline) {
         break;
       }
+
+      continue;
     }
 
-    if (event_opt) {
-      auto event = event_opt.TakeUnwrap();
-      if (!event) {
-        GetGlobalContext().LogSystemError("Internal: *event must not be null.");
-      } else {
-        std::visit(
-            [&shutdown_deadline](auto&& event) {
-              using T = std::decay_t<decltype(event)>;
-
-              if constexpr (std::is_same_v<T, runner_event::Shutdown>) {
-                if (shutdown_deadline) {
-                  GetGlobalContext().LogSystemError(
-                      "Shutdown already scheduled.");
-                  return;
-                }
-
-                runner_event::Shutdown& shutdown = event;
-                shutdown_deadline =
-                    std::chrono::steady_clock::now() + shutdown.config.timeout;
-              } else {
-                static_assert(always_false_v<T>,
-                              "every RunnerEvent must be handled.");
-              }
-            },
-            *event);
-      }
+    if (count > 0) {
+      idle_pass_count = 0;
+      continue;
     }
 
-    if (log_opt) {
-      auto log = log_opt.TakeUnwrap();
-      if (!log) {
-        GetGlobalContext().LogSystemError("Internal: *log must not be null.");
-      } else {
-        GetGlobalContext().HandleLog(*log);
-      }
+    // A burst of logs would otherwise wake the thread once per log.
+    if (++idle_pass_count < GlobalContext::kIdlePassCount) {
+      std::this_thread::yield();
+      continue;
     }
+
+    idle_pass_count = 0;
+    global_context.Park(wake_epoch);
+  }
+
+  // Rate limited sites report their counts on the next log let through,
+  // which may never come.
+  std::vector<Own<kero::Log>> suppressed_logs{};
+  for (auto& suppressed : GetLogRateLimiter().TakeSuppressed()) {
+    auto log = std::make_unique<kero::Log>("Log messages suppressed",
+                                           std::move(suppressed.location),
+                                           Level::kWarn);
+    log->data.emplace("suppressed_count",
+                      std::to_string(suppressed.suppressed_count));
+    suppressed_logs.push_back(std::move(log));
+  }
+
+  if (!suppressed_logs.empty()) {
+    global_context.HandleLogs(suppressed_logs);
   }
 }
@@ -1,14 +1,17 @@
 #ifndef KERO_LOG_GLOBAL_CONTEXT_H
 #define KERO_LOG_GLOBAL_CONTEXT_H
 
-#include <deque>
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "kero/core/mpsc_channel.h"
-#include "kero/core/spsc_channel.h"
 #include "kero/log/core.h"
+#include "kero/log/log_queue.h"
 #include "kero/log/runner_event.h"
 #include "kero/log/transport.h"
 #include "kero/log/utils.h"
@@ -28,8 +31,9 @@ class GlobalContext final {
   };
 
   struct SharedState final {
-    std::unordered_map<std::string, spsc::Rx<Own<kero::Log>>> log_rx_map{};
-    std::deque<Own<kero::Log>> orphaned_logs{};
+    LogQueueOptions log_queue_options{};
+    LogDropCounts exited_drop_counts{};
+
     std::vector<Own<Transport>> transports{};
     std::reference_wrapper<std::ostream> system_error_stream;
 
@@ -47,29 +51,180 @@ class GlobalContext final {
   auto
   LogSystemError(std::string&& message) noexcept -> void;
 
+  /**
+   * Puts `log_queue` in a free slot and returns its thread ordinal, from 1
+   * to `kMaxLogThreadCount`, or nothing when every slot is taken. The
+   * ordinal of an exited thread is given again once its queue is drained.
+   */
+  [[nodiscard]] auto
+  AddLogQueue(const Share<LogQueue>& log_queue) noexcept -> std::optional<u16>;
+
+  /**
+   * Records left in the queue are still handled by the log thread, which
+   * frees the slot after.
+   */
+  [[nodiscard]] auto
+  RemoveLogQueue(const u16 thread_ordinal) noexcept -> bool;
+
+  /**
+   * Applies to the queues of threads which log for the first time after.
+   */
+  auto
+  SetLogQueueOptions(const LogQueueOptions options) noexcept -> void;
+
   [[nodiscard]] auto
-  AddLogRx(const std::string& thread_id,
-           spsc::Rx<Own<kero::Log>>&& log_rx) noexcept -> bool;
+  GetLogQueueOptions() const noexcept -> LogQueueOptions;
 
   [[nodiscard]] auto
-  RemoveLogRx(const std::string& thread_id) noexcept -> bool;
+  GetLogDropStats() const noexcept -> LogDropStats;
 
   auto
   Shutdown(ShutdownConfig&& config) noexcept -> void;
 
+  /**
+   * The level of a transport must be set before it is added.
+   */
   auto
   AddTransport(Own<Transport>&& transport) noexcept -> void;
 
-  [[nodiscard]] auto
-  TryPopLog() noexcept -> Option<Own<kero::Log>>;
+  /**
+   * The most verbose level accepted by any transport, or `Level::kDebug`
+   * before the first transport is added. Logs more verbose than this are
+   * dropped when they are built, before being formatted or queued.
+   */
+  [[nodiscard]] static auto
+  GetLevel() noexcept -> Level {
+    return level_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Called by a thread after queueing a record. Only wakes the log thread
+   * when it is parked, which costs a fence and a load otherwise.
+   */
+  static auto
+  NotifyLog() noexcept -> void {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed) &&
+        parked_.exchange(false, std::memory_order_relaxed)) {
+      Wake();
+    }
+  }
+
+  /**
+   * Formats and handles up to `kDrainBatchSize` records of every queue, and
+   * reports drops as a warning from the thread which dropped them. Returns
+   * the number of logs handled. Called by the log thread only.
+   */
+  auto
+  DrainLogs() noexcept -> size_t;
+
+  /**
+   * Blocks the log thread until a record is queued, or `Wake` is called,
+   * after `wake_epoch` was read. Returns at once if a queue is not empty.
+   */
+  auto
+  Park(const u32 wake_epoch) noexcept -> void;
+
+  /**
+   * True once the log thread has stopped, after which queues are not
+   * drained anymore.
+   */
+  [[nodiscard]] static auto
+  IsStopped() noexcept -> bool {
+    return stopped_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] static auto
+  GetWakeEpoch() noexcept -> u32 {
+    return wake_epoch_.load(std::memory_order_acquire);
+  }
 
   auto
-  HandleLog(const kero::Log& log) const noexcept -> void;
+  HandleLogs(const std::vector<Own<kero::Log>>& logs) const noexcept -> void;
+
+  /**
+   * Visits the records still queued by every thread, without taking a lock
+   * or releasing them. For the crash handler only.
+   */
+  template <typename Visit>
+  auto
+  VisitQueuedRecordsUnsynchronized(Visit&& visit) const noexcept -> void {
+    const auto end = log_slot_end_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < end; ++i) {
+      const auto& log_slot = log_slots_[i];
+      if (log_slot.state.load(std::memory_order_acquire) ==
+          LogSlotState::kFree) {
+        continue;
+      }
+
+      if (const auto* const log_queue = log_slot.log_queue.get()) {
+        log_queue->VisitUnsynchronized(visit);
+      }
+    }
+  }
+
+  static constexpr size_t kDrainBatchSize{64};
+  static constexpr size_t kMaxLogThreadCount{256};
+
+  /**
+   * Empty passes the log thread makes, yielding in between, before it parks.
+   */
+  static constexpr u32 kIdlePassCount{64};
 
  private:
+  enum class LogSlotState : u8 {
+    kFree = 0,
+    kLive = 1,
+
+    /**
+     * The thread has exited, the log thread frees the slot once drained.
+     */
+    kExited = 2,
+  };
+
+  /**
+   * `log_queue` is set under the lock before the slot is published as live,
+   * and only reset by the log thread, so it reads it without the lock.
+   */
+  struct LogSlot final {
+    std::atomic<LogSlotState> state{LogSlotState::kFree};
+    Share<LogQueue> log_queue{};
+
+    // Owned by the log thread.
+    LogDropCounts reported_drop_counts{};
+  };
+
   GlobalContext(mpsc::Tx<Own<RunnerEvent>>&& runner_event_tx,
                 std::thread&& runner_thread) noexcept;
 
+  static auto
+  Wake() noexcept -> void {
+    wake_epoch_.fetch_add(1, std::memory_order_release);
+    wake_epoch_.notify_one();
+  }
+
+  auto
+  FreeLogSlot(LogSlot& log_slot) noexcept -> void;
+
+  [[nodiscard]] auto
+  HasPendingLogs() const noexcept -> bool;
+
+  static inline std::atomic<Level> level_{Level::kDebug};
+  static inline std::atomic<bool> parked_{false};
+  static inline std::atomic<u32> wake_epoch_{};
+  static inline std::atomic<bool> stopped_{false};
+
+  std::array<LogSlot, kMaxLogThreadCount> log_slots_{};
+
+  /**
+   * One past the highest slot ever taken, bounds the slots the log thread
+   * looks at.
+   */
+  std::atomic<size_t> log_slot_end_{};
+
+  // Owned by the log thread.
+  std::vector<Own<kero::Log>> drained_logs_{};
+
   NullStream null_stream_{};
   SharedState shared_state_;
   mutable std::mutex shared_state_mutex_{};
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <sstream>
+#include <tuple>
 
 #include "kero/log/global_context.h"
 
@@ -12,35 +13,38 @@ kero::LocalContext::Builder::Build() const noexcept
     -> Result<Own<LocalContext>> {
   using ResultT = Result<Own<LocalContext>>;
 
-  auto thread_id = ThreadIdToString(std::this_thread::get_id());
-  auto [log_tx, log_rx] = spsc::Channel<Own<kero::Log>>::Builder{}.Build();
-  if (!GetGlobalContext().AddLogRx(thread_id, std::move(log_rx))) {
+  auto log_queue =
+      std::make_shared<LogQueue>(GetGlobalContext().GetLogQueueOptions());
+  const auto thread_ordinal = GetGlobalContext().AddLogQueue(log_queue);
+  if (!thread_ordinal) {
     return ResultT::Err(Error::From(
         FlatJson{}
             .Set("message",
-                 std::string{"Failed to add log rx, thread_id already exists."})
+                 std::string{"Failed to add log queue, no free log slot."})
             .Take()));
   }
 
   return ResultT{Own<LocalContext>{
-      new LocalContext{std::move(log_tx), std::move(thread_id)}}};
+      new LocalContext{std::move(log_queue), *thread_ordinal}}};
 }
 
-kero::LocalContext::LocalContext(spsc::Tx<Own<kero::Log>>&& log_tx,
-                                 std::string&& thread_id) noexcept
-    : log_tx_{std::move(log_tx)}, thread_id_{std::move(thread_id)} {}
+kero::LocalContext::LocalContext(Share<LogQueue>&& log_queue,
+                                 const u16 thread_ordinal) noexcept
+    : log_queue_{std::move(log_queue)}, thread_ordinal_{thread_ordinal} {}
 
 kero::LocalContext::~LocalContext() noexcept {
-  if (!GetGlobalContext().RemoveLogRx(thread_id_)) {
+  if (!GetGlobalContext().RemoveLogQueue(thread_ordinal_)) {
     std::stringstream ss{};
-    ss << "Failed to remove log rx, thread_id not found: " << thread_id_;
+    ss << "Failed to remove log queue, thread_ordinal not found: "
+       << thread_ordinal_;
     GetGlobalContext().LogSystemError(ss.str());
   }
 }
 
 auto
-kero::LocalContext::SendLog(Own<kero::Log>&& log) const noexcept -> void {
-  log_tx_.Send(std::move(log));
+kero::LocalContext::SendLog(const LogRecord& record) const noexcept -> void {
+  std::ignore = log_queue_->Push(record);
+  GlobalContext::NotifyLog();
 }
 
 auto
@@ -4,8 +4,9 @@
 #include <memory>
 
 #include "kero/core/result.h"
-#include "kero/core/spsc_channel.h"
 #include "kero/log/core.h"
+#include "kero/log/log_queue.h"
+#include "kero/log/log_record.h"
 
 namespace kero {
 
@@ -22,17 +23,24 @@ class LocalContext final {
   };
 
   ~LocalContext() noexcept;
-  KERO_CLASS_KIND_MOVABLE(LocalContext);
+  KERO_CLASS_KIND_PINNABLE(LocalContext);
 
+  [[nodiscard]] auto
+  GetThreadOrdinal() const noexcept -> u16 {
+    return thread_ordinal_;
+  }
+
+  /**
+   * A full queue is handled by the overflow policy of the queue.
+   */
   auto
-  SendLog(Own<kero::Log>&& log) const noexcept -> void;
+  SendLog(const LogRecord& record) const noexcept -> void;
 
  private:
-  LocalContext(spsc::Tx<Own<kero::Log>>&& log_tx,
-               std::string&& thread_id) noexcept;
+  LocalContext(Share<LogQueue>&& log_queue, const u16 thread_ordinal) noexcept;
 
-  spsc::Tx<Own<kero::Log>> log_tx_;
-  std::string thread_id_;
+  Share<LogQueue> log_queue_;
+  u16 thread_ordinal_;
 };
 
 auto
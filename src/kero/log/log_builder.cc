@@ -1,30 +1,81 @@
 #include "log_builder.h"
 
-#include "kero/core/utils.h"
+#include <functional>
+#include <thread>
+#include <tuple>
+
 #include "kero/log/core.h"
 #include "kero/log/local_context.h"
+#include "kero/log/rate_limiter.h"
 
 using namespace kero;
 
-kero::log::LogBuilder::LogBuilder(std::string&& message,
-                                  std::source_location&& location,
-                                  const Level level) noexcept
-    : log_{std::make_unique<kero::Log>(
-          std::move(message), std::move(location), level)} {}
+auto
+kero::log::LogBuilder::RateLimit(const u32 per_second,
+                                 const u32 burst) noexcept -> LogBuilder& {
+  if (!record_) {
+    return *this;
+  }
+
+  const auto acquired =
+      GetLogRateLimiter().TryAcquire(record_->location,
+                                     record_->timestamp,
+                                     per_second,
+                                     burst > 0 ? burst : per_second);
+  if (!acquired.is_allowed) {
+    record_.reset();
+    return *this;
+  }
+
+  suppressed_count_ = acquired.suppressed_count;
+  return *this;
+}
+
+auto
+kero::log::LogBuilder::Sample(const double probability) noexcept
+    -> LogBuilder& {
+  if (!record_) {
+    return *this;
+  }
+
+  // xorshift64*, seeded per thread, is plenty for sampling.
+  thread_local u64 state{
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1};
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  const auto random =
+      static_cast<double>((state * 0x2545f4914f6cdd1dull) >> 11) * 0x1.0p-53;
+  if (random >= probability) {
+    record_.reset();
+  }
+
+  return *this;
+}
 
 auto
-kero::log::LogBuilder::Log() noexcept -> Result<Void> {
+kero::log::LogBuilder::Send() noexcept -> Result<Void> {
   using ResultT = Result<Void>;
 
-  if (!log_) {
+  if (!record_) {
     return ResultT::Err(Error::From(
         FlatJson{}
             .Set("message", std::string{"Log already consumed, cannot log."})
             .Take()));
   }
 
+  consumed_ = true;
   if (auto& local_context = GetLocalContext()) {
-    local_context->SendLog(std::move(log_));
+    if (suppressed_count_ > 0) {
+      auto location = record_->location;
+      LogBuilder summary{
+          "Log messages suppressed", std::move(location), record_->level};
+      std::ignore = summary.Data("suppressed_count", suppressed_count_).Log();
+    }
+
+    record_->thread_ordinal = local_context->GetThreadOrdinal();
+    local_context->SendLog(*record_);
+    record_.reset();
     return OkVoid();
   } else {
     return ResultT::Err(Error::From(
@@ -34,27 +85,3 @@ kero::log::LogBuilder::Log() noexcept -> Result<Void> {
             .Take()));
   }
 }
-
-auto
-kero::log::Debug(std::string&& message,
-                 std::source_location&& location) -> LogBuilder {
-  return LogBuilder{std::move(message), std::move(location), Level::kDebug};
-}
-
-auto
-kero::log::Info(std::string&& message,
-                std::source_location&& location) -> LogBuilder {
-  return LogBuilder{std::move(message), std::move(location), Level::kInfo};
-}
-
-auto
-kero::log::Warn(std::string&& message,
-                std::source_location&& location) -> LogBuilder {
-  return LogBuilder{std::move(message), std::move(location), Level::kWarn};
-}
-
-auto
-kero::log::Error(std::string&& message,
-                 std::source_location&& location) -> LogBuilder {
-  return LogBuilder{std::move(message), std::move(location), Level::kError};
-}
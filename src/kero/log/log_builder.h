@@ -1,71 +1,188 @@
 #ifndef KERO_LOG_LOG_BUILDER_H
 #define KERO_LOG_LOG_BUILDER_H
 
+#include <chrono>
+#include <optional>
+#include <ostream>
 #include <source_location>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
 
 #include "kero/core/result.h"
+#include "kero/core/utils.h"
 #include "kero/log/core.h"
 #include "kero/log/global_context.h"
+#include "kero/log/log_record.h"
 
 namespace kero {
 namespace log {
 
+[[nodiscard]] inline auto
+IsLevelEnabled(const Level level) noexcept -> bool {
+  return level <= kCompiledLevel && level <= GlobalContext::GetLevel();
+}
+
+/**
+ * Builds a `LogRecord` in place, without allocating. A builder for a
+ * disabled level holds no record, so building it costs nothing more than
+ * the level check.
+ *
+ * The arguments of `Data` are still evaluated for a disabled level, even one
+ * compiled out with `KERO_LOG_MIN_LEVEL`. Logs whose arguments cost something
+ * to compute use `KERO_LOG_DEBUG` and the other macros below, which skip the
+ * whole statement.
+ */
 class LogBuilder final {
  public:
-  explicit LogBuilder(std::string&& message,
+  explicit LogBuilder(const std::string_view message,
                       std::source_location&& location,
-                      const Level level) noexcept;
+                      const Level level) noexcept {
+    if (!IsLevelEnabled(level)) {
+      return;
+    }
+
+    auto& record = record_.emplace();
+    record.timestamp = std::chrono::steady_clock::now();
+    record.location = location;
+    record.level = level;
+    record.message = record.AppendText(message);
+  }
+
   ~LogBuilder() noexcept = default;
   KERO_CLASS_KIND_PINNABLE(LogBuilder);
 
-  template <typename T>
+  /**
+   * Lets at most `per_second` logs through this call site per second, across
+   * all threads, in bursts of up to `burst` (`per_second` if zero). The next
+   * log let through is preceded by a count of those suppressed, and counts
+   * left at shutdown are logged by the log thread.
+   *
+   * Call it before `Data`, so suppressed logs skip building their fields.
+   */
+  [[nodiscard]] auto
+  RateLimit(const u32 per_second, const u32 burst = 0) noexcept
+      -> LogBuilder&;
+
+  /**
+   * Keeps the log with `probability`. Unlike `RateLimit`, dropped logs are
+   * not counted.
+   */
+  [[nodiscard]] auto
+  Sample(const double probability) noexcept -> LogBuilder&;
+
+  /**
+   * Numbers are stored as is and strings are copied, other values are
+   * streamed with `operator<<` into the record.
+   */
+  template <size_t N, typename T>
   [[nodiscard]] auto
-  Data(std::string&& key, T&& value) noexcept -> LogBuilder& {
-    std::stringstream ss;
-    ss << std::forward<T>(value);
+  Data(const char (&key)[N], T&& value) noexcept -> LogBuilder& {
+    if (!record_) {
+      return *this;
+    }
 
-    const auto entry = log_->data.find(key);
-    if (entry != log_->data.end()) {
-      GetGlobalContext().LogSystemError("Overwriting existing data key: " +
-                                        key);
+    auto* const field = record_->AddField(key);
+    if (!field) {
+      return *this;
+    }
 
-      entry->second = ss.str();
+    using D = std::decay_t<T>;
+    if constexpr (std::is_same_v<D, bool>) {
+      field->value = value;
+    } else if constexpr (std::is_same_v<D, char>) {
+      field->value = record_->AppendText(std::string_view{&value, 1});
+    } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+      field->value = static_cast<i64>(value);
+    } else if constexpr (std::is_integral_v<D>) {
+      field->value = static_cast<u64>(value);
+    } else if constexpr (std::is_floating_point_v<D>) {
+      field->value = static_cast<double>(value);
+    } else if constexpr (std::is_same_v<D, const char*> ||
+                         std::is_same_v<D, char*>) {
+      field->value =
+          record_->AppendText(value ? std::string_view{value} : "");
+    } else if constexpr (std::is_convertible_v<T&&, std::string_view>) {
+      field->value = record_->AppendText(std::string_view{value});
     } else {
-      log_->data.emplace(key, ss.str());
+      LogTextStreamBuf buf{*record_};
+      std::ostream os{&buf};
+      os << std::forward<T>(value);
+      field->value = buf.Finish();
     }
 
     return *this;
   }
 
+  /**
+   * Does nothing when the level is disabled.
+   */
   auto
-  Log() noexcept -> Result<Void>;
+  Log() noexcept -> Result<Void> {
+    if (!record_ && !consumed_) {
+      return OkVoid();
+    }
+
+    return Send();
+  }
 
  private:
-  Own<kero::Log> log_;
+  auto
+  Send() noexcept -> Result<Void>;
+
+  std::optional<LogRecord> record_;
+  u64 suppressed_count_{};
+  bool consumed_{false};
 };
 
-[[nodiscard]] auto
-Debug(std::string&& message,
+[[nodiscard]] inline auto
+Debug(const std::string_view message,
       std::source_location&& location = std::source_location::current())
-    -> LogBuilder;
+    -> LogBuilder {
+  return LogBuilder{message, std::move(location), Level::kDebug};
+}
 
-[[nodiscard]] auto
-Info(std::string&& message,
+[[nodiscard]] inline auto
+Info(const std::string_view message,
      std::source_location&& location = std::source_location::current())
-    -> LogBuilder;
+    -> LogBuilder {
+  return LogBuilder{message, std::move(location), Level::kInfo};
+}
 
-[[nodiscard]] auto
-Warn(std::string&& message,
+[[nodiscard]] inline auto
+Warn(const std::string_view message,
      std::source_location&& location = std::source_location::current())
-    -> LogBuilder;
+    -> LogBuilder {
+  return LogBuilder{message, std::move(location), Level::kWarn};
+}
 
-[[nodiscard]] auto
-Error(std::string&& message,
+[[nodiscard]] inline auto
+Error(const std::string_view message,
       std::source_location&& location = std::source_location::current())
-    -> LogBuilder;
+    -> LogBuilder {
+  return LogBuilder{message, std::move(location), Level::kError};
+}
 
 }  // namespace log
 }  // namespace kero
 
+/**
+ * Like `log::Debug` and the others, but nothing after the macro, `Data`
+ * arguments included, is evaluated when the level is disabled:
+ *
+ *   KERO_LOG_DEBUG("Battle ended").Data("stats", FormatStats()).Log();
+ *
+ * The `if` folds away for levels compiled out with `KERO_LOG_MIN_LEVEL`.
+ */
+#define KERO_LOG_AT(level, builder)          \
+  if (!::kero::log::IsLevelEnabled(level)) { \
+  } else                                     \
+    ::kero::log::builder
+
+#define KERO_LOG_DEBUG(message) \
+  KERO_LOG_AT(::kero::Level::kDebug, Debug(message))
+#define KERO_LOG_INFO(message) KERO_LOG_AT(::kero::Level::kInfo, Info(message))
+#define KERO_LOG_WARN(message) KERO_LOG_AT(::kero::Level::kWarn, Warn(message))
+#define KERO_LOG_ERROR(message) \
+  KERO_LOG_AT(::kero::Level::kError, Error(message))
+
 #endif  // KERO_LOG_LOG_BUILDER_H
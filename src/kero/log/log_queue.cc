@@ -0,0 +1,89 @@
+#include "log_queue.h"
+
+#include <thread>
+#include <tuple>
+
+#include "kero/log/global_context.h"
+
+using namespace kero;
+
+kero::LogQueue::LogQueue(const LogQueueOptions options) noexcept
+    : options_{options} {
+  if (options_.sample_rate == 0) {
+    options_.sample_rate = 1;
+  }
+}
+
+auto
+kero::LogQueue::Push(const LogRecord& record) noexcept -> bool {
+  const auto write = [&record](LogRecord& slot) noexcept {
+    record.CopyTo(slot);
+  };
+
+  switch (options_.overflow_policy) {
+    case LogOverflowPolicy::kDropNewest:
+      break;
+    case LogOverflowPolicy::kDropOldest:
+      if (ring_.TryPushWith(write)) {
+        return true;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(consumer_mutex_);
+        std::ignore =
+            ring_.TryPopWith([this](const LogRecord& oldest) noexcept {
+              CountDrop(oldest.level);
+            });
+      }
+      break;
+    case LogOverflowPolicy::kBlock:
+      while (!ring_.TryPushWith(write)) {
+        // Nothing makes room once the log thread has stopped.
+        if (GlobalContext::IsStopped()) {
+          CountDrop(record.level);
+          return false;
+        }
+
+        GlobalContext::NotifyLog();
+        std::this_thread::yield();
+      }
+      return true;
+    case LogOverflowPolicy::kSample:
+      if (ring_.Size() >= kCapacity / 2 &&
+          ++sample_count_ % options_.sample_rate != 0) {
+        CountDrop(record.level);
+        return false;
+      }
+      break;
+  }
+
+  if (ring_.TryPushWith(write)) {
+    return true;
+  }
+
+  CountDrop(record.level);
+  return false;
+}
+
+auto
+kero::LogQueue::IsEmpty() const noexcept -> bool {
+  return ring_.IsEmpty();
+}
+
+auto
+kero::LogQueue::GetDropCounts() const noexcept -> LogDropCounts {
+  LogDropCounts counts{};
+  for (size_t i = 0; i < kLevelCount; ++i) {
+    counts[i] = drop_counts_[i].load(std::memory_order_relaxed);
+  }
+
+  return counts;
+}
+
+auto
+kero::LogQueue::CountDrop(const Level level) noexcept -> void {
+  // Only the producer counts, so a load and a store are enough.
+  auto& count = drop_counts_[LevelToIndex(level)];
+  count.store(count.load(std::memory_order_relaxed) + 1,
+              std::memory_order_relaxed);
+}
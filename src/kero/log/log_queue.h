@@ -0,0 +1,135 @@
+#ifndef KERO_LOG_LOG_QUEUE_H
+#define KERO_LOG_LOG_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <utility>
+
+#include "kero/core/common.h"
+#include "kero/core/spsc_ring.h"
+#include "kero/log/core.h"
+#include "kero/log/log_record.h"
+
+namespace kero {
+
+/**
+ * What a thread does with a record when its log queue is full.
+ */
+enum class LogOverflowPolicy : u8 {
+  kDropNewest = 0,
+
+  /**
+   * Discards the oldest queued record to make room.
+   */
+  kDropOldest = 1,
+
+  /**
+   * Waits for the log thread to make room. Logging may then stall the
+   * thread which logs.
+   */
+  kBlock = 2,
+
+  /**
+   * Keeps one in `sample_rate` records once the queue is half full, and
+   * drops the newest when it is full.
+   */
+  kSample = 3,
+};
+
+struct LogQueueOptions final {
+  LogOverflowPolicy overflow_policy{LogOverflowPolicy::kDropNewest};
+  u32 sample_rate{8};
+};
+
+/**
+ * Indexed by `LevelToIndex`.
+ */
+using LogDropCounts = std::array<u64, kLevelCount>;
+
+struct LogDropStats final {
+  struct Thread final {
+    u16 thread_ordinal{};
+    LogDropCounts drop_counts{};
+  };
+
+  std::vector<Thread> threads{};
+
+  /**
+   * Sums the threads which have exited.
+   */
+  LogDropCounts exited_drop_counts{};
+};
+
+/**
+ * Per-thread queue of log records. The thread which logs is the only
+ * producer and the log thread is the only consumer. Only the used part of a
+ * record is copied into its slot, so short logs touch little of the ring.
+ *
+ * Dropped records are counted per level, the counts only grow.
+ */
+class LogQueue final {
+ public:
+  explicit LogQueue(const LogQueueOptions options) noexcept;
+  ~LogQueue() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(LogQueue);
+
+  /**
+   * Called by the thread which owns the queue only. Returns false when
+   * `record` itself was dropped.
+   */
+  [[nodiscard]] auto
+  Push(const LogRecord& record) noexcept -> bool;
+
+  /**
+   * Called by the log thread only.
+   */
+  template <typename Read>
+  [[nodiscard]] auto
+  PopWith(Read&& read) noexcept -> bool {
+    if (options_.overflow_policy != LogOverflowPolicy::kDropOldest) {
+      return ring_.TryPopWith(std::forward<Read>(read));
+    }
+
+    std::lock_guard<std::mutex> lock(consumer_mutex_);
+    return ring_.TryPopWith(std::forward<Read>(read));
+  }
+
+  /**
+   * See `spsc::Ring::VisitUnsynchronized`.
+   */
+  template <typename Visit>
+  auto
+  VisitUnsynchronized(Visit&& visit) const noexcept -> void {
+    ring_.VisitUnsynchronized(std::forward<Visit>(visit));
+  }
+
+  [[nodiscard]] auto
+  IsEmpty() const noexcept -> bool;
+
+  [[nodiscard]] auto
+  GetDropCounts() const noexcept -> LogDropCounts;
+
+  static constexpr size_t kCapacity{512};
+
+ private:
+  auto
+  CountDrop(const Level level) noexcept -> void;
+
+  spsc::Ring<LogRecord, kCapacity> ring_;
+  std::array<std::atomic<u64>, kLevelCount> drop_counts_{};
+
+  /**
+   * With `kDropOldest` the producer discards the oldest record as a
+   * consumer would, so both sides take this to pop.
+   */
+  std::mutex consumer_mutex_{};
+
+  LogQueueOptions options_;
+  u32 sample_count_{};
+};
+
+}  // namespace kero
+
+#endif  // KERO_LOG_LOG_QUEUE_H
@@ -0,0 +1,50 @@
+#include "log_record.h"
+
+#include <sstream>
+
+#include "kero/log/global_context.h"
+
+using namespace kero;
+
+auto
+kero::LogRecordToLog(const LogRecord& record) noexcept -> Own<Log> {
+  auto location = record.location;
+  auto log = std::make_unique<Log>(std::string{record.GetText(record.message)},
+                                   std::move(location),
+                                   record.level,
+                                   SteadyToSystemTime(record.timestamp));
+  log->thread_ordinal = record.thread_ordinal;
+
+  for (u8 i = 0; i < record.field_count; ++i) {
+    const auto& field = record.fields[i];
+    std::stringstream ss;
+    std::visit(
+        [&ss, &record](const auto& value) {
+          using T = std::decay_t<decltype(value)>;
+
+          if constexpr (std::is_same_v<T, LogText>) {
+            ss << record.GetText(value);
+          } else {
+            ss << value;
+          }
+        },
+        field.value);
+
+    std::string key{field.key};
+    const auto entry = log->data.find(key);
+    if (entry != log->data.end()) {
+      GetGlobalContext().LogSystemError("Overwriting existing data key: " +
+                                        key);
+
+      entry->second = ss.str();
+    } else {
+      log->data.emplace(std::move(key), ss.str());
+    }
+  }
+
+  if (record.truncated) {
+    GetGlobalContext().LogSystemError("Log record truncated: " + log->message);
+  }
+
+  return log;
+}
@@ -0,0 +1,165 @@
+#ifndef KERO_LOG_LOG_RECORD_H
+#define KERO_LOG_LOG_RECORD_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <ostream>
+#include <source_location>
+#include <streambuf>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "kero/core/common.h"
+#include "kero/log/core.h"
+
+namespace kero {
+
+/**
+ * A string stored in the text area of a `LogRecord`.
+ */
+struct LogText final {
+  u16 offset{};
+  u16 size{};
+};
+
+using LogValue = std::variant<i64, u64, double, bool, LogText>;
+
+struct LogField final {
+  /**
+   * Points to a string literal, only the pointer is copied.
+   */
+  const char* key{};
+  LogValue value{};
+};
+
+/**
+ * Fixed-size, trivially copyable form of a `Log`, built by the thread which
+ * logs without allocating. Numbers are stored raw and strings are copied
+ * into the text area; formatting them into a `Log` is left to the log thread.
+ *
+ * Fields past `kMaxFieldCount` are dropped and strings past the text area
+ * are cut, both mark the record as truncated.
+ */
+struct LogRecord final {
+  static constexpr size_t kMaxFieldCount{8};
+  static constexpr size_t kTextCapacity{4096};
+
+  /**
+   * User-provided so that the text area is left uninitialized.
+   */
+  LogRecord() noexcept {}
+
+  std::source_location location{};
+
+  /**
+   * Read from the monotonic clock when the record is built, which is cheaper
+   * than the wall clock and unaffected by its adjustments.
+   */
+  std::chrono::steady_clock::time_point timestamp{};
+
+  Level level{};
+
+  /**
+   * The ordinal of the thread which logged, see `GlobalContext::AddLogQueue`.
+   */
+  u16 thread_ordinal{};
+
+  u8 field_count{};
+  bool truncated{};
+  u16 text_size{};
+  LogText message{};
+  std::array<LogField, kMaxFieldCount> fields;
+  std::array<char, kTextCapacity> text;
+
+  auto
+  AppendText(const std::string_view str) noexcept -> LogText {
+    const auto available = text.size() - text_size;
+    const auto size = std::min(str.size(), available);
+    truncated |= size < str.size();
+    std::memcpy(text.data() + text_size, str.data(), size);
+
+    const LogText log_text{.offset = text_size,
+                           .size = static_cast<u16>(size)};
+    text_size += static_cast<u16>(size);
+    return log_text;
+  }
+
+  [[nodiscard]] auto
+  GetText(const LogText log_text) const noexcept -> std::string_view {
+    return std::string_view{text.data() + log_text.offset, log_text.size};
+  }
+
+  /**
+   * Copies the record up to the end of its used text.
+   */
+  auto
+  CopyTo(LogRecord& other) const noexcept -> void {
+    const auto* const begin = reinterpret_cast<const char*>(this);
+    std::memcpy(static_cast<void*>(&other),
+                begin,
+                static_cast<size_t>(text.data() - begin) + text_size);
+  }
+
+  [[nodiscard]] auto
+  AddField(const char* key) noexcept -> LogField* {
+    if (field_count == fields.size()) {
+      truncated = true;
+      return nullptr;
+    }
+
+    auto& field = fields[field_count++];
+    field.key = key;
+    return &field;
+  }
+};
+
+static_assert(std::is_trivially_copyable_v<LogRecord>);
+
+/**
+ * Streams into the free text area of a `LogRecord`, for values which only
+ * provide `operator<<`. Output past the area is cut.
+ */
+class LogTextStreamBuf final : public std::streambuf {
+ public:
+  explicit LogTextStreamBuf(LogRecord& record) noexcept : record_{record} {
+    auto* const begin = record.text.data() + record.text_size;
+    setp(begin, record.text.data() + record.text.size());
+  }
+
+  ~LogTextStreamBuf() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(LogTextStreamBuf);
+
+  /**
+   * Commits the streamed characters to the record.
+   */
+  [[nodiscard]] auto
+  Finish() noexcept -> LogText {
+    const auto size = static_cast<u16>(pptr() - pbase());
+    const LogText log_text{.offset = record_.text_size, .size = size};
+    record_.text_size += size;
+    return log_text;
+  }
+
+ protected:
+  auto
+  overflow([[maybe_unused]] int c) noexcept -> int override {
+    record_.truncated = true;
+    return traits_type::eof();
+  }
+
+ private:
+  LogRecord& record_;
+};
+
+/**
+ * Formats the fields of `record`, this is where a log allocates.
+ */
+[[nodiscard]] auto
+LogRecordToLog(const LogRecord& record) noexcept -> Own<Log>;
+
+}  // namespace kero
+
+#endif  // KERO_LOG_LOG_RECORD_H
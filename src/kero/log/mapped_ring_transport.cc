@@ -0,0 +1,118 @@
+#include "mapped_ring_transport.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "kero/core/utils_linux.h"
+#include "kero/log/file_json_lines_transport.h"
+
+using namespace kero;
+
+static constexpr char kMagic[8] = {'K', 'E', 'R', 'O', 'R', 'I', 'N', 'G'};
+
+auto
+kero::MappedRingTransport::Builder::Build(
+    MappedRingOptions&& options) const noexcept
+    -> Result<Own<MappedRingTransport>> {
+  using ResultT = Result<Own<MappedRingTransport>>;
+
+  if (options.path.empty() || options.slot_count == 0 ||
+      options.slot_size < 2) {
+    return ResultT::Err(Error::From(
+        FlatJson{}
+            .Set("message",
+                 std::string{"Mapped ring needs a path, slots and a slot "
+                             "size of at least 2"})
+            .Take()));
+  }
+
+  const auto fail = [&options](const int fd, const char* message) {
+    auto details = Errno::FromErrno().IntoFlatJson();
+    if (fd >= 0) {
+      ::close(fd);
+    }
+
+    return ResultT::Err(Error::From(details.Set("message", std::string{message})
+                                        .Set("path", options.path)
+                                        .Take()));
+  };
+
+  const auto fd =
+      ::open(options.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return fail(fd, "Failed to open mapped ring file");
+  }
+
+  const auto mapped_size =
+      kHeaderSize + static_cast<size_t>(options.slot_count) * options.slot_size;
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) == -1) {
+    return fail(fd, "Failed to stat mapped ring file");
+  }
+
+  const auto is_resized = static_cast<size_t>(file_stat.st_size) != mapped_size;
+  if (is_resized && ::ftruncate(fd, static_cast<off_t>(mapped_size)) == -1) {
+    return fail(fd, "Failed to size mapped ring file");
+  }
+
+  auto* const mapped = static_cast<char*>(::mmap(
+      nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+  if (mapped == MAP_FAILED) {
+    return fail(fd, "Failed to map mapped ring file");
+  }
+
+  Own<MappedRingTransport> transport{
+      new MappedRingTransport{fd, mapped, mapped_size}};
+
+  // A file from an earlier run with the same geometry is continued.
+  auto& header = transport->GetHeader();
+  const auto is_continued =
+      !is_resized && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+      header.slot_size == options.slot_size &&
+      header.slot_count == options.slot_count;
+  if (!is_continued) {
+    std::memset(mapped, 0, mapped_size);
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.slot_size = options.slot_size;
+    header.slot_count = options.slot_count;
+    header.next_slot = 0;
+  }
+
+  return ResultT{std::move(transport)};
+}
+
+kero::MappedRingTransport::MappedRingTransport(
+    const int fd, char* const mapped, const size_t mapped_size) noexcept
+    : mapped_{mapped}, mapped_size_{mapped_size}, fd_{fd} {}
+
+kero::MappedRingTransport::~MappedRingTransport() noexcept {
+  ::munmap(mapped_, mapped_size_);
+  ::close(fd_);
+}
+
+auto
+kero::MappedRingTransport::OnLog(const Log& log) noexcept -> void {
+  line_.clear();
+  AppendJsonLine(line_, log, timestamp_cache_);
+
+  auto& header = GetHeader();
+  auto* const slot = mapped_ + kHeaderSize +
+                     (header.next_slot % header.slot_count) * header.slot_size;
+
+  // A cut line still ends with a newline, the rest is zero padding.
+  const auto size = std::min<size_t>(line_.size(), header.slot_size - 1);
+  std::memcpy(slot, line_.data(), size);
+  slot[size - 1] = '\n';
+  std::memset(slot + size, 0, header.slot_size - size);
+  ++header.next_slot;
+}
+
+auto
+kero::MappedRingTransport::GetHeader() noexcept -> Header& {
+  return *reinterpret_cast<Header*>(mapped_);
+}
@@ -0,0 +1,86 @@
+#ifndef KERO_LOG_MAPPED_RING_TRANSPORT_H
+#define KERO_LOG_MAPPED_RING_TRANSPORT_H
+
+#include <string>
+
+#include "kero/core/result.h"
+#include "kero/log/core.h"
+#include "kero/log/transport.h"
+#include "kero/log/utils.h"
+
+namespace kero {
+
+struct MappedRingOptions final {
+  std::string path{};
+
+  /**
+   * How many of the latest logs the file keeps.
+   */
+  u32 slot_count{1024};
+
+  /**
+   * Bytes per log, longer JSON lines are cut.
+   */
+  u32 slot_size{512};
+};
+
+/**
+ * Keeps the latest logs in a file mapped with `MAP_SHARED`. Each log is a
+ * JSON line stored in a fixed-size, zero-padded slot. The kernel owns the
+ * mapped pages, so they reach the file even when the process is killed with
+ * SIGKILL, with no write or sync per log.
+ *
+ * The file starts with a 64-byte header: the magic `KERORING`, then the
+ * slot size, slot count and next slot index in native byte order. An
+ * existing file with the same geometry is continued where it stopped, so
+ * copy it aside before restarting to keep a crash intact. To read it:
+ * `tail -c +65 <path> | tr -d '\0'`, which lists the slots in file order.
+ */
+class MappedRingTransport : public Transport {
+ public:
+  class Builder {
+   public:
+    Builder() noexcept = default;
+    ~Builder() noexcept = default;
+    KERO_CLASS_KIND_PINNABLE(Builder);
+
+    [[nodiscard]] auto
+    Build(MappedRingOptions&& options) const noexcept
+        -> Result<Own<MappedRingTransport>>;
+  };
+
+  virtual ~MappedRingTransport() noexcept;
+  KERO_CLASS_KIND_PINNABLE(MappedRingTransport);
+
+  virtual auto
+  OnLog(const Log& log) noexcept -> void override;
+
+  static constexpr size_t kHeaderSize{64};
+
+ private:
+  struct Header final {
+    char magic[8];
+    u32 slot_size;
+    u32 slot_count;
+    u64 next_slot;
+  };
+
+  static_assert(sizeof(Header) <= kHeaderSize);
+
+  explicit MappedRingTransport(const int fd,
+                               char* const mapped,
+                               const size_t mapped_size) noexcept;
+
+  [[nodiscard]] auto
+  GetHeader() noexcept -> Header&;
+
+  std::string line_{};
+  Iso8601Cache timestamp_cache_{};
+  char* mapped_;
+  size_t mapped_size_;
+  int fd_;
+};
+
+}  // namespace kero
+
+#endif  // KERO_LOG_MAPPED_RING_TRANSPORT_H
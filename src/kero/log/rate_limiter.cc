@@ -0,0 +1,78 @@
+#include "rate_limiter.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace kero;
+
+auto
+kero::LogRateLimiter::KeyHash::operator()(const Key& key) const noexcept
+    -> size_t {
+  const auto hash = std::hash<const char*>{}(key.file_name) ^
+                    (static_cast<size_t>(key.line) << 16) ^ key.column;
+  // Mixes the bits, the shard is picked from the high ones.
+  return hash * 0x9e3779b97f4a7c15ull;
+}
+
+auto
+kero::LogRateLimiter::TryAcquire(
+    const std::source_location& location,
+    const std::chrono::steady_clock::time_point now,
+    const u32 per_second,
+    const u32 burst) noexcept -> Acquired {
+  const Key key{.file_name = location.file_name(),
+                .line = location.line(),
+                .column = location.column()};
+  const auto hash = KeyHash{}(key);
+  auto& shard = shards_[hash >> 60];
+  const auto capacity = static_cast<double>(std::max(burst, 1u));
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto& bucket =
+      shard.buckets
+          .try_emplace(key,
+                       Bucket{.location = location,
+                              .refilled_at = now,
+                              .tokens = capacity})
+          .first->second;
+
+  const auto elapsed =
+      std::chrono::duration<double>(now - bucket.refilled_at).count();
+  if (elapsed > 0) {
+    bucket.tokens = std::min(capacity, bucket.tokens + elapsed * per_second);
+    bucket.refilled_at = now;
+  }
+
+  if (bucket.tokens < 1) {
+    ++bucket.suppressed_count;
+    return Acquired{.is_allowed = false};
+  }
+
+  bucket.tokens -= 1;
+  return Acquired{
+      .is_allowed = true,
+      .suppressed_count = std::exchange(bucket.suppressed_count, 0)};
+}
+
+auto
+kero::LogRateLimiter::TakeSuppressed() noexcept -> std::vector<Suppressed> {
+  std::vector<Suppressed> suppressed{};
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& [_, bucket] : shard.buckets) {
+      if (bucket.suppressed_count > 0) {
+        suppressed.push_back(Suppressed{
+            .location = bucket.location,
+            .suppressed_count = std::exchange(bucket.suppressed_count, 0)});
+      }
+    }
+  }
+
+  return suppressed;
+}
+
+auto
+kero::GetLogRateLimiter() -> LogRateLimiter& {
+  static LogRateLimiter rate_limiter{};
+  return rate_limiter;
+}
@@ -0,0 +1,96 @@
+#ifndef KERO_LOG_RATE_LIMITER_H
+#define KERO_LOG_RATE_LIMITER_H
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <source_location>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "kero/core/common.h"
+
+namespace kero {
+
+/**
+ * Token buckets keyed by the call site of a log, shared by all threads.
+ * Sites are spread over shards, so threads logging from different sites
+ * rarely wait on each other.
+ */
+class LogRateLimiter final {
+ public:
+  struct Acquired final {
+    bool is_allowed{};
+
+    /**
+     * Logs suppressed at the site since the last one allowed. Only set when
+     * `is_allowed`, and reset by it.
+     */
+    u64 suppressed_count{};
+  };
+
+  struct Suppressed final {
+    std::source_location location;
+    u64 suppressed_count{};
+  };
+
+  explicit LogRateLimiter() noexcept = default;
+  ~LogRateLimiter() noexcept = default;
+  KERO_CLASS_KIND_PINNABLE(LogRateLimiter);
+
+  /**
+   * Takes a token from the bucket of `location`, which refills at
+   * `per_second` up to `burst` tokens.
+   */
+  [[nodiscard]] auto
+  TryAcquire(const std::source_location& location,
+             const std::chrono::steady_clock::time_point now,
+             const u32 per_second,
+             const u32 burst) noexcept -> Acquired;
+
+  /**
+   * Returns and resets the counts of every site which suppressed a log
+   * since the last one allowed.
+   */
+  [[nodiscard]] auto
+  TakeSuppressed() noexcept -> std::vector<Suppressed>;
+
+ private:
+  struct Key final {
+    const char* file_name{};
+    u32 line{};
+    u32 column{};
+
+    auto
+    operator==(const Key& other) const noexcept -> bool = default;
+  };
+
+  struct KeyHash final {
+    auto
+    operator()(const Key& key) const noexcept -> size_t;
+  };
+
+  struct Bucket final {
+    std::source_location location;
+    std::chrono::steady_clock::time_point refilled_at;
+    double tokens{};
+    u64 suppressed_count{};
+  };
+
+  struct alignas(64) Shard final {
+    std::mutex mutex;
+    std::unordered_map<Key, Bucket, KeyHash> buckets;
+  };
+
+  static constexpr size_t kShardCount{16};
+
+  std::array<Shard, kShardCount> shards_{};
+};
+
+auto
+GetLogRateLimiter() -> LogRateLimiter&;
+
+}  // namespace kero
+
+#endif  // KERO_LOG_RATE_LIMITER_H
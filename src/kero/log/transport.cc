@@ -1,6 +1,7 @@
 #include "transport.h"
 
 #include <iostream>
+#include <tuple>
 
 #include "kero/log/utils.h"
 
@@ -33,7 +34,7 @@ kero::ConsolePlainTextTransport::OnLog(const Log& log) noexcept -> void {
   size_t indent{0};
   PrintIndent(os, indent);
 
-  const auto datetime = TimePointToIso8601(std::chrono::system_clock::now());
+  const auto datetime = TimePointToIso8601(log.timestamp);
   os << datetime;
   os << " ";
   os << LevelToString(log.level);
@@ -74,3 +75,65 @@ kero::ConsolePlainTextTransport::OnLog(const Log& log) noexcept -> void {
     os << "\n";
   }
 }
+
+kero::BufferedPlainTextTransport::BufferedPlainTextTransport(
+    const int fd) noexcept
+    : fd_{fd} {
+  buffer_.reserve(kFlushThreshold * 2);
+}
+
+kero::BufferedPlainTextTransport::~BufferedPlainTextTransport() noexcept {
+  OnFlush();
+}
+
+auto
+kero::BufferedPlainTextTransport::OnLog(const Log& log) noexcept -> void {
+  auto& buffer = buffer_;
+  timestamp_cache_.Append(buffer, log.timestamp);
+  buffer += ' ';
+  buffer += LevelToString(log.level);
+  buffer += " - ";
+  buffer += log.message;
+  buffer += '\n';
+
+  if (!log.data.empty()) {
+    buffer += "  data:\n";
+    for (const auto& [key, value] : log.data) {
+      buffer += "    ";
+      buffer += key;
+      buffer += ": ";
+      buffer += value;
+      buffer += '\n';
+    }
+  }
+
+  if (log.location.file_name() != nullptr) {
+    buffer += "  location: ";
+    buffer += log.location.file_name();
+    buffer += ':';
+    AppendNumber(buffer, log.location.line());
+    buffer += ':';
+    AppendNumber(buffer, log.location.column());
+    buffer += '\n';
+  }
+
+  if (log.location.function_name() != nullptr) {
+    buffer += "  function: ";
+    buffer += log.location.function_name();
+    buffer += '\n';
+  }
+
+  if (buffer.size() >= kFlushThreshold) {
+    OnFlush();
+  }
+}
+
+auto
+kero::BufferedPlainTextTransport::OnFlush() noexcept -> void {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  std::ignore = WriteAll(fd_, buffer_);
+  buffer_.clear();
+}
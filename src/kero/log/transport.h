@@ -1,7 +1,10 @@
 #ifndef KERO_LOG_TRANSPORT_H
 #define KERO_LOG_TRANSPORT_H
 
+#include <string>
+
 #include "kero/log/core.h"
+#include "kero/log/utils.h"
 
 namespace kero {
 
@@ -21,6 +24,12 @@ class Transport {
   virtual auto
   OnLog(const Log& log) noexcept -> void = 0;
 
+  /**
+   * Called after each batch of logs is handled.
+   */
+  virtual auto
+  OnFlush() noexcept -> void {}
+
  protected:
   Level level_;
 };
@@ -35,6 +44,37 @@ class ConsolePlainTextTransport : public Transport {
   OnLog(const Log& log) noexcept -> void override;
 };
 
+/**
+ * Formats logs like `ConsolePlainTextTransport` into a reusable buffer and
+ * writes it to `fd` with a single `write` per batch. The date and time of a
+ * timestamp are only formatted again when its second changes. The file
+ * descriptor is not owned.
+ *
+ * Write errors drop the buffered logs, reporting them would log again.
+ */
+class BufferedPlainTextTransport : public Transport {
+ public:
+  explicit BufferedPlainTextTransport(const int fd = 1) noexcept;
+  virtual ~BufferedPlainTextTransport() noexcept;
+  KERO_CLASS_KIND_PINNABLE(BufferedPlainTextTransport);
+
+  virtual auto
+  OnLog(const Log& log) noexcept -> void override;
+
+  virtual auto
+  OnFlush() noexcept -> void override;
+
+  /**
+   * Buffered bytes past which a batch is written before it ends.
+   */
+  static constexpr size_t kFlushThreshold{64 * 1024};
+
+ private:
+  std::string buffer_{};
+  Iso8601Cache timestamp_cache_{};
+  int fd_;
+};
+
 }  // namespace kero
 
 #endif  // KERO_LOG_TRANSPORT_H
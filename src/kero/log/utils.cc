@@ -1,5 +1,10 @@
 #include "utils.h"
 
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <ctime>
 #include <iomanip>
 #include <sstream>
 #include <thread>
@@ -23,10 +28,75 @@ kero::ThreadIdToString(const std::thread::id& thread_id) -> std::string {
 auto
 kero::TimePointToIso8601(
     const std::chrono::system_clock::time_point& time_point) -> std::string {
-  auto timer = std::chrono::system_clock::to_time_t(time_point);
+  const auto seconds =
+      std::chrono::time_point_cast<std::chrono::seconds>(time_point);
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                          time_point - seconds)
+                          .count();
+  auto timer = std::chrono::system_clock::to_time_t(seconds);
   std::tm tm_utc{};
   gmtime_r(&timer, &tm_utc);
   std::stringstream ss;
-  ss << std::put_time(&tm_utc, "%FT%TZ");
+  ss << std::put_time(&tm_utc, "%FT%T") << '.' << std::setfill('0')
+     << std::setw(6) << micros << 'Z';
   return ss.str();
 }
+
+auto
+kero::Iso8601Cache::Append(
+    std::string& out,
+    const std::chrono::system_clock::time_point time_point) noexcept -> void {
+  using namespace std::chrono;
+
+  const auto seconds = time_point_cast<std::chrono::seconds>(time_point);
+  if (const auto count = seconds.time_since_epoch().count();
+      count != datetime_seconds_) {
+    const auto timer = system_clock::to_time_t(seconds);
+    std::tm tm_utc{};
+    gmtime_r(&timer, &tm_utc);
+
+    char formatted[32];
+    const auto size =
+        std::strftime(formatted, sizeof(formatted), "%FT%T", &tm_utc);
+    datetime_.assign(formatted, size);
+    datetime_seconds_ = count;
+  }
+
+  // Zero-padded microseconds, built from the back.
+  auto micros = static_cast<u32>(
+      duration_cast<microseconds>(time_point - seconds).count());
+  char fraction[] = ".000000Z";
+  for (size_t i = 6; i > 0 && micros > 0; --i, micros /= 10) {
+    fraction[i] = static_cast<char>('0' + micros % 10);
+  }
+
+  out += datetime_;
+  out.append(fraction, sizeof(fraction) - 1);
+}
+
+auto
+kero::AppendNumber(std::string& out, const u64 value) noexcept -> void {
+  char digits[20];
+  const auto [end, _] =
+      std::to_chars(std::begin(digits), std::end(digits), value);
+  out.append(digits, end);
+}
+
+auto
+kero::WriteAll(const int fd, const std::string_view data) noexcept -> bool {
+  size_t written{0};
+  while (written < data.size()) {
+    const auto res = ::write(fd, data.data() + written, data.size() - written);
+    if (res < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return false;
+    }
+
+    written += static_cast<size_t>(res);
+  }
+
+  return true;
+}
@@ -1,7 +1,10 @@
 #ifndef KERO_LOG_UTILS_H
 #define KERO_LOG_UTILS_H
 
+#include <chrono>
 #include <ostream>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -39,6 +42,36 @@ auto
 TimePointToIso8601(const std::chrono::system_clock::time_point& time_point)
     -> std::string;
 
+/**
+ * Appends timestamps in the format of `TimePointToIso8601`, formatting the
+ * date and time again only when the second changes.
+ */
+class Iso8601Cache final {
+ public:
+  Iso8601Cache() noexcept = default;
+  ~Iso8601Cache() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(Iso8601Cache);
+
+  auto
+  Append(std::string& out,
+         const std::chrono::system_clock::time_point time_point) noexcept
+      -> void;
+
+ private:
+  std::string datetime_{};
+  i64 datetime_seconds_{-1};
+};
+
+auto
+AppendNumber(std::string& out, const u64 value) noexcept -> void;
+
+/**
+ * Writes all of `data` to `fd`, retrying partial and interrupted writes.
+ * Returns false on any other error.
+ */
+[[nodiscard]] auto
+WriteAll(const int fd, const std::string_view data) noexcept -> bool;
+
 template <typename T>
 auto
 operator<<(std::ostream& os, const std::vector<T>& vec) -> std::ostream& {
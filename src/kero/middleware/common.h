@@ -15,6 +15,7 @@ enum : ServiceKindId {
   kServiceKindId_TcpServer,
   kServiceKindId_Config,
   kServiceKindId_SocketRouter,
+  kServiceKindId_Timer,
 
   kServiceKindId_MiddlewareEnd,
 };
@@ -24,6 +25,12 @@ struct EventSocketOpen {
   static constexpr auto kSocketId = "socket_id";
 };
 
+struct EventSocketOpenBatch {
+  static constexpr auto kEvent = "socket_open_batch";
+  static constexpr auto kCount = "count";
+  static constexpr auto kSocketIdPrefix = "socket_id_";
+};
+
 struct EventSocketError {
   static constexpr auto kEvent = "socket_error";
   static constexpr auto kSocketId = "socket_id";
@@ -41,9 +48,25 @@ struct EventSocketRead {
   static constexpr auto kSocketId = "socket_id";
 };
 
+/**
+ * Sent by `SocketPoolService` to quiet sockets, and accepted from clients as
+ * `__event` to keep their connection alive.
+ */
+struct EventHeartbeat {
+  static constexpr auto kEvent = "heartbeat";
+};
+
 struct EventSocketMove {
   static constexpr auto kEvent = "socket_move";
   static constexpr auto kSocketId = "socket_id";
+
+  /**
+   * Steady clock time of the export in microseconds, the importer reports the
+   * handoff latency from it.
+   */
+  static constexpr auto kExportedAtUs = "exported_at_us";
+
+  // Other keys hold the exported `SocketCodec` state.
 };
 
 }  // namespace kero
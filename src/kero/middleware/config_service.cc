@@ -1,11 +1,52 @@
 #include "config_service.h"
 
+#include <algorithm>
+#include <array>
+
 #include "kero/core/args_scanner.h"
 #include "kero/core/utils.h"
 #include "kero/log/log_builder.h"
 
 using namespace kero;
 
+namespace {
+
+struct NumberArg {
+  std::string_view flag;
+  std::string_view key;
+};
+
+// Integer socket options, see `TcpSocketOptions`.
+constexpr std::array kSocketOptionArgs{
+    NumberArg{"--backlog", "backlog"},
+    NumberArg{"--send-buffer", "send_buffer_size"},
+    NumberArg{"--receive-buffer", "receive_buffer_size"},
+    NumberArg{"--keepalive-idle", "keepalive_idle"},
+    NumberArg{"--keepalive-interval", "keepalive_interval"},
+    NumberArg{"--keepalive-count", "keepalive_count"},
+    NumberArg{"--tcp-defer-accept", "tcp_defer_accept"},
+    NumberArg{"--tcp-fastopen", "tcp_fastopen"},
+};
+
+// Durations in milliseconds, zero disables the feature.
+constexpr std::array kDurationArgs{
+    NumberArg{"--idle-timeout", "idle_timeout_ms"},
+    NumberArg{"--heartbeat-interval", "heartbeat_interval_ms"},
+};
+
+template <size_t N>
+[[nodiscard]] static auto
+FindNumberArg(const std::array<NumberArg, N>& args,
+              const std::string_view flag) noexcept -> const NumberArg* {
+  const auto found =
+      std::find_if(args.begin(), args.end(), [flag](const NumberArg& arg) {
+        return arg.flag == flag;
+      });
+  return found != args.end() ? &*found : nullptr;
+}
+
+}  // namespace
+
 kero::ConfigService::ConfigService(const Borrow<RunnerContext> runner_context,
                                    FlatJson&& config) noexcept
     : Service{runner_context, {}}, config_{std::move(config)} {}
@@ -32,12 +73,30 @@ kero::ConfigService::GetConfig() noexcept -> FlatJson& {
 kero::ConfigServiceFactory::ConfigServiceFactory(int argc, char** argv) noexcept
     : args_{Args{argv, argv + argc}} {}
 
+kero::ConfigServiceFactory::ConfigServiceFactory(int argc,
+                                                 char** argv,
+                                                 FlatJson&& overrides) noexcept
+    : args_{Args{argv, argv + argc}}, overrides_{std::move(overrides)} {}
+
 auto
 kero::ConfigServiceFactory::Create(
     const Borrow<RunnerContext> runner_context) noexcept
     -> Result<Own<Service>> {
   using ResultT = Result<Own<Service>>;
 
+  auto config_res = Parse();
+  if (config_res.IsErr()) {
+    return ResultT::Err(config_res.TakeErr());
+  }
+
+  return ResultT::Ok(std::make_unique<ConfigService>(runner_context,
+                                                     config_res.TakeOk()));
+}
+
+auto
+kero::ConfigServiceFactory::Parse() const noexcept -> Result<FlatJson> {
+  using ResultT = Result<FlatJson>;
+
   FlatJson config{};
   ArgsScanner scanner{args_};
 
@@ -51,22 +110,56 @@ kero::ConfigServiceFactory::Create(
 
     const auto& token = current.Unwrap();
     if (token == "--port") {
+      if (auto res = ParseNumberArg<u16>(
+              scanner, config, "port", kPortNotFound, kPortParsingFailed);
+          res.IsErr()) {
+        return ResultT::Err(res.TakeErr());
+      }
+    } else if (token == "--accept-budget") {
+      if (auto res = ParseNumberArg<u32>(scanner,
+                                         config,
+                                         "accept_budget",
+                                         kAcceptBudgetNotFound,
+                                         kAcceptBudgetParsingFailed);
+          res.IsErr()) {
+        return ResultT::Err(res.TakeErr());
+      }
+    } else if (token == "--bind-address") {
       const auto next = scanner.Next();
       if (!next) {
-        return ResultT::Err(Error::From(kPortNotFound));
+        return ResultT::Err(Error::From(kBindAddressNotFound));
       }
 
-      auto port_str = next.Unwrap();
-      auto res = ParseNumberString<u16>(port_str);
-      if (res.IsErr()) {
-        return ResultT::Err(
-            Error::From(kPortParsingFailed,
-                        FlatJson{}.Set("port", std::move(port_str)).Take(),
-                        res.TakeErr()));
-      };
-
-      (void)config.Set("port", res.TakeOk());
+      (void)config.Set("bind_address", std::string{next.Unwrap()});
       scanner.Eat();
+    } else if (token == "--ipv6") {
+      (void)config.Set("ipv6", true);
+    } else if (token == "--ipv6-only") {
+      (void)config.Set("ipv6_only", true);
+    } else if (token == "--no-tcp-nodelay") {
+      (void)config.Set("tcp_nodelay", false);
+    } else if (token == "--tcp-quickack") {
+      (void)config.Set("tcp_quickack", true);
+    } else if (token == "--keepalive") {
+      (void)config.Set("keepalive", true);
+    } else if (const auto option = FindNumberArg(kSocketOptionArgs, token)) {
+      if (auto res = ParseNumberArg<i32>(scanner,
+                                         config,
+                                         std::string{option->key},
+                                         kSocketOptionNotFound,
+                                         kSocketOptionParsingFailed);
+          res.IsErr()) {
+        return ResultT::Err(res.TakeErr());
+      }
+    } else if (const auto duration = FindNumberArg(kDurationArgs, token)) {
+      if (auto res = ParseNumberArg<u32>(scanner,
+                                         config,
+                                         std::string{duration->key},
+                                         kDurationNotFound,
+                                         kDurationParsingFailed);
+          res.IsErr()) {
+        return ResultT::Err(res.TakeErr());
+      }
     } else {
       return ResultT::Err(
           Error::From(kUnknownArgument,
@@ -76,6 +169,38 @@ kero::ConfigServiceFactory::Create(
     scanner.Eat();
   }
 
-  return ResultT::Ok(
-      std::make_unique<ConfigService>(runner_context, std::move(config)));
+  for (const auto& [key, value] : overrides_.AsRaw()) {
+    config.AsRaw().insert_or_assign(key, value);
+  }
+
+  return ResultT::Ok(std::move(config));
+}
+
+template <typename T>
+auto
+kero::ConfigServiceFactory::ParseNumberArg(ArgsScanner& scanner,
+                                           FlatJson& config,
+                                           std::string&& key,
+                                           const Error::Code not_found,
+                                           const Error::Code parsing_failed)
+    const noexcept -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  const auto next = scanner.Next();
+  if (!next) {
+    return ResultT::Err(Error::From(not_found));
+  }
+
+  auto value_str = next.Unwrap();
+  auto res = ParseNumberString<T>(value_str);
+  if (res.IsErr()) {
+    return ResultT::Err(
+        Error::From(parsing_failed,
+                    FlatJson{}.Set(std::move(key), std::move(value_str)).Take(),
+                    res.TakeErr()));
+  }
+
+  (void)config.Set(std::move(key), res.TakeOk());
+  scanner.Eat();
+  return OkVoid();
 }
@@ -35,18 +35,51 @@ class ConfigServiceFactory : public ServiceFactory {
   enum : Error::Code {
     kPortNotFound = 1,
     kPortParsingFailed,
-    kUnknownArgument
+    kUnknownArgument,
+    kAcceptBudgetNotFound,
+    kAcceptBudgetParsingFailed,
+    kBindAddressNotFound,
+    kSocketOptionNotFound,
+    kSocketOptionParsingFailed,
+    kDurationNotFound,
+    kDurationParsingFailed,
   };
 
   explicit ConfigServiceFactory(int argc, char** argv) noexcept;
+
+  /**
+   * `overrides` are applied on top of the parsed arguments. This lets several
+   * runners share the same command line while differing in a few keys.
+   */
+  explicit ConfigServiceFactory(int argc,
+                                char** argv,
+                                FlatJson&& overrides) noexcept;
+
   virtual ~ConfigServiceFactory() noexcept override = default;
 
   [[nodiscard]] virtual auto
   Create(const Borrow<RunnerContext> runner_context) noexcept
       -> Result<Own<Service>> override;
 
+  /**
+   * The config of the arguments with `overrides` applied, as `Create` passes
+   * to the `ConfigService`.
+   */
+  [[nodiscard]] auto
+  Parse() const noexcept -> Result<FlatJson>;
+
  private:
+  template <typename T>
+  [[nodiscard]] auto
+  ParseNumberArg(ArgsScanner& scanner,
+                 FlatJson& config,
+                 std::string&& key,
+                 const Error::Code not_found,
+                 const Error::Code parsing_failed) const noexcept
+      -> Result<Void>;
+
   Args args_;
+  FlatJson overrides_;
 };
 
 }  // namespace kero
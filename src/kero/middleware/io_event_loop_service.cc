@@ -72,7 +72,10 @@ kero::IoEventLoopService::OnDestroy() noexcept -> void {
 auto
 kero::IoEventLoopService::OnUpdate() noexcept -> void {
   if (!Fd::IsValid(epoll_fd_)) {
-    log::Error("Invalid epoll fd").Data("fd", epoll_fd_).Log();
+    log::Error("Invalid epoll fd")
+        .RateLimit(kErrorLogsPerSecond)
+        .Data("fd", epoll_fd_)
+        .Log();
     return;
   }
 
@@ -135,7 +138,8 @@ kero::IoEventLoopService::OnUpdateEpollEvent(
                 .Set(EventSocketError::kSocketId,
                      static_cast<u64>(event.data.fd))
                 .Set(EventSocketError::kErrorCode, code)
-                .Set(EventSocketError::kErrorDescription, description))) {
+                .Set(EventSocketError::kErrorDescription, description));
+        res.IsErr()) {
       log::Error("Failed to invoke socket error event")
           .Data("error", res.TakeErr())
           .Log();
@@ -146,7 +150,8 @@ kero::IoEventLoopService::OnUpdateEpollEvent(
     if (auto res =
             InvokeEvent(EventSocketClose::kEvent,
                         FlatJson{}.Set(EventSocketClose::kSocketId,
-                                       static_cast<u64>(event.data.fd)))) {
+                                       static_cast<u64>(event.data.fd)));
+        res.IsErr()) {
       log::Error("Failed to invoke socket close event")
           .Data("error", res.TakeErr())
           .Log();
@@ -56,6 +56,11 @@ class IoEventLoopService final : public Service {
   Fd::Value epoll_fd_{Fd::kUnspecifiedInitialValue};
 
   static constexpr size_t kMaxEvents = 1024;
+
+  /**
+   * Per call site, errors in `OnUpdate` may fire on every tick.
+   */
+  static constexpr u32 kErrorLogsPerSecond{10};
 };
 
 }  // namespace kero
@@ -1,23 +1,97 @@
 #ifndef KERO_MIDDLEWARE_SOCKET_POOL_SERVICE_H
 #define KERO_MIDDLEWARE_SOCKET_POOL_SERVICE_H
 
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <span>
+
 #include "kero/core/common.h"
-#include "kero/core/flat_json_parser.h"
-#include "kero/core/flat_json_scanner.h"
+#include "kero/core/frame_codec.h"
+#include "kero/core/frame_template.h"
 #include "kero/core/utils.h"
 #include "kero/engine/service.h"
 #include "kero/engine/service_kind.h"
 #include "kero/log/log_builder.h"
 #include "kero/middleware/common.h"
 #include "kero/middleware/io_event_loop_service.h"
+#include "kero/middleware/socket_table.h"
+#include "kero/middleware/timer_service.h"
 
 namespace kero {
 
+template <typename UserData>
 struct SocketInfo {
-  FlatJsonScanner scanner{};
+  SocketCodec codec{};
+  UserData user_data{};
+  u64 last_read_ms{};
+  TimerId idle_timer{TimerService::kInvalidTimerId};
+  TimerId heartbeat_timer{TimerService::kInvalidTimerId};
+};
+
+/**
+ * Zero disables the timer.
+ */
+struct SocketPoolOptions {
+  /**
+   * Sockets which sent nothing for this long are shut down, so the usual close
+   * path runs for them.
+   */
+  u64 idle_timeout_ms{};
+
+  /**
+   * Sockets which sent nothing for this long are sent a heartbeat event. A
+   * client answering it stays clear of the idle timeout.
+   */
+  u64 heartbeat_interval_ms{};
+
+  /**
+   * Sets `TCP_QUICKACK` again after every read. The kernel clears it on its
+   * own, so setting it once at accept only covers the first reads.
+   */
+  bool tcp_quickack{false};
+
+  [[nodiscard]] static auto
+  FromConfig(const FlatJson& config) noexcept -> SocketPoolOptions {
+    SocketPoolOptions options{};
+    if (const auto idle_timeout_ms = config.TryGet<u32>("idle_timeout_ms")) {
+      options.idle_timeout_ms = idle_timeout_ms.Unwrap();
+    }
+
+    if (const auto heartbeat_interval_ms =
+            config.TryGet<u32>("heartbeat_interval_ms")) {
+      options.heartbeat_interval_ms = heartbeat_interval_ms.Unwrap();
+    }
+
+    if (const auto tcp_quickack = config.TryGet<bool>("tcp_quickack")) {
+      options.tcp_quickack = tcp_quickack.Unwrap();
+    }
+
+    return options;
+  }
+};
+
+/**
+ * Time from `ExportSocket` on one runner to `ImportSocket` on the next, over
+ * the sockets imported so far.
+ */
+struct SocketHandoffStats {
+  u64 count{};
+  u64 total_us{};
+  u64 max_us{};
 };
 
-template <typename T>
+/**
+ * `UserData` is per socket state of the derived service, stored next to the
+ * codec in the socket table.
+ *
+ * Needs a `TimerService` on the same runner for `SocketPoolOptions`.
+ */
+template <typename T, typename UserData = Void>
 class SocketPoolService : public Service {
  public:
   using MethodEventHandler =
@@ -26,10 +100,14 @@ class SocketPoolService : public Service {
 
   explicit SocketPoolService(
       const Borrow<RunnerContext> runner_context,
-      DependencyDeclarations&& dependency_declarations) noexcept
-      : Service{runner_context, {kServiceKindId_IoEventLoop}} {
+      DependencyDeclarations&& dependency_declarations,
+      const SocketPoolOptions options = {}) noexcept
+      : Service{runner_context,
+                {kServiceKindId_IoEventLoop, kServiceKindId_Timer}},
+        options_{options} {
     for (const auto dependency : dependency_declarations) {
-      if (dependency == kServiceKindId_IoEventLoop) {
+      if (dependency == kServiceKindId_IoEventLoop ||
+          dependency == kServiceKindId_Timer) {
         continue;
       }
 
@@ -50,11 +128,43 @@ class SocketPoolService : public Service {
       return ResultT::Err(res.TakeErr());
     }
 
+    if (auto res = RegisterMethodEventHandler(EventHeartbeat::kEvent,
+                                              &SocketPoolService::OnHeartbeat);
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+
     return OkVoid();
   }
 
+  /**
+   * Sockets still registered are shut down for writing before they are
+   * closed, so replies already written reach the peer.
+   */
   virtual auto
   OnDestroy() noexcept -> void override {
+    const std::vector<SocketId> socket_ids{socket_table_.GetLive().begin(),
+                                           socket_table_.GetLive().end()};
+    for (const auto socket_id : socket_ids) {
+      (void)UnregisterSocket(socket_id);
+      (void)::shutdown(static_cast<Fd::Value>(socket_id), SHUT_WR);
+      if (auto res = Fd::Close(static_cast<Fd::Value>(socket_id));
+          res.IsErr()) {
+        log::Error("Failed to close socket")
+            .Data("socket_id", socket_id)
+            .Data("error", res.TakeErr())
+            .Log();
+      }
+    }
+
+    if (handoff_stats_.count > 0) {
+      log::Info("Socket handoff latency")
+          .Data("count", handoff_stats_.count)
+          .Data("avg_us", handoff_stats_.total_us / handoff_stats_.count)
+          .Data("max_us", handoff_stats_.max_us)
+          .Log();
+    }
+
     for (const auto& [event, _] : event_handler_map_) {
       if (auto res = UnsubscribeEvent(event); res.IsErr()) {
         log::Error("Failed to unsubscribe event")
@@ -65,11 +175,24 @@ class SocketPoolService : public Service {
     }
   }
 
+  /**
+   * Tells every registered socket that the server is going away. Derived
+   * services which override this must call it too.
+   */
+  virtual auto
+  OnShutdown() noexcept -> void override {
+    is_shutting_down_ = true;
+    for (const auto socket_id : socket_table_.GetLive()) {
+      WriteShutdown(socket_id);
+    }
+  }
+
   virtual auto
   OnEvent(const std::string& event,
           const FlatJson& data) noexcept -> void override {
     if (auto res = InvokeMethodEvent(event, data); res.IsErr()) {
       log::Error("Failed to handle event")
+          .RateLimit(kErrorLogsPerSecond)
           .Data("event", event)
           .Data("error", res.TakeErr())
           .Log();
@@ -89,6 +212,15 @@ class SocketPoolService : public Service {
     }
 
     const auto socket_id = socket_id_opt.Unwrap();
+
+    // Other services on the same runner (e.g. a listen socket owned by
+    // `TcpServerService`) share the read event, so skip fds we do not own
+    // before touching them.
+    auto socket_info = socket_table_.Find(socket_id);
+    if (!socket_info) {
+      return OkVoid();
+    }
+
     auto read_res = GetDependency<IoEventLoopService>()->ReadFromFd(socket_id);
     if (read_res.IsErr()) {
       auto err = read_res.TakeErr();
@@ -99,53 +231,398 @@ class SocketPoolService : public Service {
       return ResultT::Err(std::move(err));
     }
 
-    auto found_socket_info = socket_map_.find(socket_id);
-    if (found_socket_info == socket_map_.end()) {
-      return ResultT::Err(
-          FlatJson{}.Set("message", "Socket info not found").Take());
+    socket_info.Unwrap().codec.Push(read_res.TakeOk());
+    if (options_.tcp_quickack) {
+      // Best effort, a failure only delays the next ACK.
+      const int enabled{1};
+      (void)::setsockopt(static_cast<Fd::Value>(socket_id),
+                         IPPROTO_TCP,
+                         TCP_QUICKACK,
+                         &enabled,
+                         sizeof(enabled));
     }
 
-    auto& socket_info = found_socket_info->second;
-    socket_info.scanner.Push(read_res.TakeOk());
-    auto token_opt = socket_info.scanner.Pop();
-    if (!token_opt) {
-      return OkVoid();
+    if (IsTimed()) {
+      socket_info.Unwrap().last_read_ms =
+          GetDependency<TimerService>()->GetNowMs();
+    }
+
+    return DispatchBufferedFrames(socket_id);
+  }
+
+  /**
+   * Handles every complete frame in the codec of the socket. An imported
+   * socket may arrive with frames its previous owner read but never handled;
+   * the new owner calls this once it is ready for them.
+   *
+   * A frame which fails to decode or to be handled is logged and skipped.
+   * The socket is edge triggered, so frames left in the codec would wait for
+   * the next read. A broken stream cannot be framed again, so the socket is
+   * closed, see `CloseBrokenSocket`.
+   */
+  [[nodiscard]] auto
+  DispatchBufferedFrames(const SocketId socket_id) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    std::string payload;
+    while (true) {
+      // A handler may unregister or move the socket, so look it up again
+      // before each frame.
+      auto current_socket_info = socket_table_.Find(socket_id);
+      if (!current_socket_info) {
+        return OkVoid();
+      }
+
+      auto& codec = current_socket_info.Unwrap().codec;
+      auto popped = codec.Pop(payload);
+      if (popped.IsErr()) {
+        CloseBrokenSocket(socket_id, popped.TakeErr());
+        return OkVoid();
+      }
+
+      if (codec.TakeUpgraded()) {
+        // Answer in the format the peer asked for.
+        if (auto res = GetDependency<IoEventLoopService>()->WriteToFd(
+                socket_id,
+                codec.SwitchWriteFormat(codec.GetReadFormat()));
+            res.IsErr()) {
+          return ResultT::Err(res.TakeErr());
+        }
+      }
+
+      if (!popped.Ok()) {
+        return OkVoid();
+      }
+
+      auto decoded = codec.DecodePayload(payload);
+      if (decoded.IsErr()) {
+        LogFrameError(socket_id, "", decoded.TakeErr());
+        continue;
+      }
+
+      auto read_data = decoded.TakeOk();
+      auto event_opt = read_data.template TryGet<std::string>("__event");
+      if (!event_opt) {
+        LogFrameError(
+            socket_id,
+            "",
+            Error::From(FlatJson{}
+                            .Set("message", "Failed to get event from data")
+                            .Take()));
+        continue;
+      }
+
+      (void)read_data.Set("__socket_id", socket_id);
+      const auto event = event_opt.Unwrap();
+      if (auto res = InvokeMethodEvent(event, read_data); res.IsErr()) {
+        LogFrameError(socket_id, event, res.TakeErr());
+      }
+    }
+  }
+
+  /**
+   * Services see the close event as for a peer which closed, so they release
+   * what they hold for the socket. The socket is then out of epoll, so it is
+   * shut down and closed here instead of on its hang-up.
+   */
+  auto
+  CloseBrokenSocket(const SocketId socket_id, Error&& error) noexcept
+      -> void {
+    log::Error("Closing socket with a broken stream")
+        .Data("socket_id", socket_id)
+        .Data("error", std::move(error))
+        .Log();
+
+    if (auto res = InvokeEvent(
+            EventSocketClose::kEvent,
+            FlatJson{}.Set(EventSocketClose::kSocketId, socket_id));
+        res.IsErr()) {
+      log::Error("Failed to invoke socket close event")
+          .Data("socket_id", socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+
+    if (socket_table_.Find(socket_id)) {
+      (void)UnregisterSocket(socket_id);
+    }
+
+    (void)CloseSocket(socket_id);
+    if (auto res = Fd::Close(static_cast<Fd::Value>(socket_id));
+        res.IsErr()) {
+      log::Error("Failed to close socket")
+          .Data("socket_id", socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+  }
+
+  auto
+  LogFrameError(const SocketId socket_id,
+                const std::string& event,
+                Error&& error) noexcept -> void {
+    log::Error("Failed to handle frame")
+        .RateLimit(kErrorLogsPerSecond)
+        .Data("socket_id", socket_id)
+        .Data("event", event)
+        .Data("error", std::move(error))
+        .Log();
+  }
+
+  /**
+   * Activity was already recorded when the frame was read.
+   */
+  [[nodiscard]] auto
+  OnHeartbeat([[maybe_unused]] const FlatJson& data) noexcept -> Result<Void> {
+    return OkVoid();
+  }
+
+  /**
+   * Frames `data` with the codec negotiated for the socket and writes it.
+   */
+  [[nodiscard]] auto
+  WriteToSocket(const SocketId socket_id,
+                const FlatJson& data) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    auto socket_info = socket_table_.Find(socket_id);
+    if (!socket_info) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket not registered")
+                              .Set("socket_id", socket_id)
+                              .Take());
+    }
+
+    auto frame = socket_info.Unwrap().codec.EncodeFrame(data);
+    if (frame.IsErr()) {
+      return ResultT::Err(frame.TakeErr());
+    }
+
+    return GetDependency<IoEventLoopService>()->WriteToFd(socket_id,
+                                                          frame.TakeOk());
+  }
+
+  /**
+   * Writes `frame_template` with `values` in its slots, without building a
+   * `FlatJson` for sockets using the text payload.
+   */
+  [[nodiscard]] auto
+  WriteToSocket(const SocketId socket_id,
+                const FrameTemplate& frame_template,
+                const std::initializer_list<u64> values) noexcept
+      -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    auto socket_info = socket_table_.Find(socket_id);
+    if (!socket_info) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket not registered")
+                              .Set("socket_id", socket_id)
+                              .Take());
+    }
+
+    auto frame = socket_info.Unwrap().codec.EncodeFrame(
+        frame_template, std::span<const u64>{values.begin(), values.size()});
+    if (frame.IsErr()) {
+      return ResultT::Err(frame.TakeErr());
+    }
+
+    return GetDependency<IoEventLoopService>()->WriteToFd(socket_id,
+                                                          frame.TakeOk());
+  }
+
+  [[nodiscard]] auto
+  WriteToSocket(const SocketHandle handle,
+                const FrameTemplate& frame_template,
+                const std::initializer_list<u64> values) noexcept
+      -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    if (!socket_table_.Find(handle)) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket handle is stale")
+                              .Set("socket_id", handle.socket_id)
+                              .Set("generation", handle.generation)
+                              .Take());
+    }
+
+    return WriteToSocket(handle.socket_id, frame_template, values);
+  }
+
+  /**
+   * Best effort, a socket which can not be written to is closing anyway.
+   */
+  auto
+  WriteShutdown(const SocketId socket_id) noexcept -> void {
+    if (auto res = WriteToSocket(
+            socket_id, FlatJson{}.Set("event", EventShutdown::kEvent).Take());
+        res.IsErr()) {
+      log::Warn("Failed to notify socket of shutdown")
+          .Data("socket_id", socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+  }
+
+  /**
+   * Like `WriteToSocket(const SocketId, ...)`, but fails instead of writing to
+   * a socket which reused the fd of a closed one.
+   */
+  [[nodiscard]] auto
+  WriteToSocket(const SocketHandle handle,
+                const FlatJson& data) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    if (!socket_table_.Find(handle)) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket handle is stale")
+                              .Set("socket_id", handle.socket_id)
+                              .Set("generation", handle.generation)
+                              .Take());
     }
 
-    auto token = token_opt.Unwrap();
-    auto parsed = FlatJsonParser{}.Parse(token);
-    if (parsed.IsErr()) {
-      return ResultT::Err(parsed.TakeErr());
+    return WriteToSocket(handle.socket_id, data);
+  }
+
+  /**
+   * Unregisters the socket and returns the data of a socket move event which
+   * carries its codec state to the next owner, see `ImportSocket`.
+   */
+  [[nodiscard]] auto
+  ExportSocket(const SocketId socket_id) noexcept -> Result<FlatJson> {
+    using ResultT = Result<FlatJson>;
+
+    auto socket_info = socket_table_.Find(socket_id);
+    if (!socket_info) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket not registered")
+                              .Set("socket_id", socket_id)
+                              .Take());
+    }
+
+    auto data = socket_info.Unwrap().codec.Export();
+    (void)data.Set(EventSocketMove::kSocketId, socket_id)
+        .Set(EventSocketMove::kExportedAtUs, GetSteadyNowUs());
+    if (auto res = UnregisterSocket(socket_id); res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
     }
 
-    auto read_data = parsed.TakeOk();
-    auto event_opt = read_data.template TryGet<std::string>("__event");
-    if (!event_opt) {
+    return ResultT::Ok(std::move(data));
+  }
+
+  /**
+   * Registers a socket from the data of a socket move event. Sockets moved
+   * without codec state start with the default codec.
+   *
+   * Each runner owns its epoll set, so a move is a `EPOLL_CTL_DEL` there and
+   * a `EPOLL_CTL_ADD` here. The socket is added edge triggered, which reports
+   * bytes that arrived in between at once; bytes the previous owner already
+   * read travel in the codec state, see `DispatchBufferedFrames`.
+   */
+  [[nodiscard]] auto
+  ImportSocket(const FlatJson& data) noexcept -> Result<SocketId> {
+    using ResultT = Result<SocketId>;
+
+    auto socket_id_opt = data.TryGet<u64>(EventSocketMove::kSocketId);
+    if (!socket_id_opt) {
       return ResultT::Err(
-          FlatJson{}.Set("message", "Failed to get event from data").Take());
+          FlatJson{}
+              .Set("message", "Failed to get socket id from data")
+              .Take());
     }
 
-    (void)read_data.Set("__socket_id", socket_id);
-    const auto event = event_opt.Unwrap();
-    if (auto res = InvokeMethodEvent(event, read_data); res.IsErr()) {
+    const auto socket_id = socket_id_opt.Unwrap();
+    auto codec = SocketCodec::Import(data);
+    if (codec.IsErr()) {
+      return ResultT::Err(codec.TakeErr());
+    }
+
+    if (auto res = RegisterSocket(socket_id, codec.TakeOk()); res.IsErr()) {
       return ResultT::Err(res.TakeErr());
     }
 
-    return OkVoid();
+    if (const auto exported_at_us =
+            data.TryGet<u64>(EventSocketMove::kExportedAtUs)) {
+      const auto now_us = GetSteadyNowUs();
+      const auto handoff_us =
+          now_us - std::min(exported_at_us.Unwrap(), now_us);
+      ++handoff_stats_.count;
+      handoff_stats_.total_us += handoff_us;
+      handoff_stats_.max_us = std::max(handoff_stats_.max_us, handoff_us);
+      log::Debug("Socket imported")
+          .Data("socket_id", socket_id)
+          .Data("handoff_us", handoff_us)
+          .Log();
+    }
+
+    return ResultT::Ok(SocketId{socket_id});
   }
 
   [[nodiscard]] auto
   RegisterSocket(const SocketId socket_id) noexcept -> Result<Void> {
+    return RegisterSocket(socket_id, SocketCodec{});
+  }
+
+  [[nodiscard]] auto
+  RegisterSocket(const SocketId socket_id,
+                 SocketCodec&& codec) noexcept -> Result<Void> {
     using ResultT = Result<Void>;
 
+    auto handle = socket_table_.Insert(
+        socket_id, SocketInfo<UserData>{.codec = std::move(codec)});
+    if (handle.IsNone()) {
+      return ResultT::Err(FlatJson{}
+                              .Set("message", "Socket already registered")
+                              .Set("socket_id", socket_id)
+                              .Take());
+    }
+
     if (auto res = GetDependency<IoEventLoopService>()->AddFd(
             socket_id,
             {.in = true, .edge_trigger = true});
         res.IsErr()) {
+      socket_table_.Erase(socket_id);
       return ResultT::Err(res.TakeErr());
     }
 
-    socket_map_.emplace(socket_id, SocketInfo{});
+    if (IsTimed()) {
+      auto& socket_info = socket_table_.Find(socket_id).Unwrap();
+      socket_info.last_read_ms = GetDependency<TimerService>()->GetNowMs();
+      if (options_.idle_timeout_ms > 0) {
+        socket_info.idle_timer =
+            ScheduleSocketTimer(handle.Unwrap(),
+                                options_.idle_timeout_ms,
+                                &SocketPoolService::OnIdleTimer);
+      }
+
+      if (options_.heartbeat_interval_ms > 0) {
+        socket_info.heartbeat_timer =
+            ScheduleSocketTimer(handle.Unwrap(),
+                                options_.heartbeat_interval_ms,
+                                &SocketPoolService::OnHeartbeatTimer);
+      }
+    }
+
+    return OkVoid();
+  }
+
+  /**
+   * Shuts the socket down. The peer sees the connection closed, and the socket
+   * close event follows from the event loop as for any other closed socket.
+   */
+  [[nodiscard]] auto
+  CloseSocket(const SocketId socket_id) noexcept -> Result<Void> {
+    using ResultT = Result<Void>;
+
+    if (::shutdown(static_cast<Fd::Value>(socket_id), SHUT_RDWR) == -1) {
+      return ResultT::Err(Error::From(
+          Errno::FromErrno()
+              .IntoFlatJson()
+              .Set("message", std::string{"Failed to shut down socket"})
+              .Set("socket_id", socket_id)
+              .Take()));
+    }
+
     return OkVoid();
   }
 
@@ -153,7 +630,13 @@ class SocketPoolService : public Service {
   UnregisterSocket(const SocketId socket_id) noexcept -> Result<Void> {
     log::Debug("Unregistering socket").Data("socket_id", socket_id).Log();
 
-    if (socket_map_.erase(socket_id) == 0) {
+    if (auto socket_info = socket_table_.Find(socket_id)) {
+      GetDependency<TimerService>()->Cancel(socket_info.Unwrap().idle_timer);
+      GetDependency<TimerService>()->Cancel(
+          socket_info.Unwrap().heartbeat_timer);
+    }
+
+    if (!socket_table_.Erase(socket_id)) {
       log::Error("Failed to remove socket_id from set")
           .Data("socket_id", socket_id)
           .Log();
@@ -212,10 +695,142 @@ class SocketPoolService : public Service {
   }
 
  protected:
-  std::unordered_map<SocketId, SocketInfo> socket_map_;
+  [[nodiscard]] auto
+  GetUserData(const SocketId socket_id) noexcept -> OptionRef<UserData&> {
+    auto socket_info = socket_table_.Find(socket_id);
+    if (!socket_info) {
+      return None;
+    }
+
+    return OptionRef<UserData&>::Some(socket_info.Unwrap().user_data);
+  }
+
+  /**
+   * Returns `None` when the socket was closed or its fd reused since the
+   * handle was taken.
+   */
+  [[nodiscard]] auto
+  GetUserData(const SocketHandle handle) noexcept -> OptionRef<UserData&> {
+    auto socket_info = socket_table_.Find(handle);
+    if (!socket_info) {
+      return None;
+    }
+
+    return OptionRef<UserData&>::Some(socket_info.Unwrap().user_data);
+  }
+
+  [[nodiscard]] auto
+  IsShuttingDown() const noexcept -> bool {
+    return is_shutting_down_;
+  }
+
+  [[nodiscard]] auto
+  GetHandoffStats() const noexcept -> const SocketHandoffStats& {
+    return handoff_stats_;
+  }
+
+  SocketTable<SocketInfo<UserData>> socket_table_;
 
  private:
+  using TimerHandler = void (SocketPoolService::*)(const SocketHandle) noexcept;
+
+  [[nodiscard]] static auto
+  GetSteadyNowUs() noexcept -> u64 {
+    return static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  [[nodiscard]] auto
+  IsTimed() const noexcept -> bool {
+    return options_.idle_timeout_ms > 0 || options_.heartbeat_interval_ms > 0;
+  }
+
+  /**
+   * The handle keeps a timer of a closed socket from acting on a new socket
+   * which reused its fd.
+   */
+  [[nodiscard]] auto
+  ScheduleSocketTimer(const SocketHandle handle,
+                      const u64 delay_ms,
+                      const TimerHandler handler) noexcept -> TimerId {
+    return GetDependency<TimerService>()->Schedule(
+        delay_ms, [this, handle, handler] { (this->*handler)(handle); });
+  }
+
+  /**
+   * Reads do not touch the timer; it checks the last read when it fires and
+   * sleeps again for the time left.
+   */
+  auto
+  OnIdleTimer(const SocketHandle handle) noexcept -> void {
+    auto socket_info = socket_table_.Find(handle);
+    if (!socket_info) {
+      return;
+    }
+
+    auto& info = socket_info.Unwrap();
+    const auto idle_ms =
+        GetDependency<TimerService>()->GetNowMs() - info.last_read_ms;
+    if (idle_ms < options_.idle_timeout_ms) {
+      info.idle_timer = ScheduleSocketTimer(handle,
+                                            options_.idle_timeout_ms - idle_ms,
+                                            &SocketPoolService::OnIdleTimer);
+      return;
+    }
+
+    info.idle_timer = TimerService::kInvalidTimerId;
+    log::Info("Closing idle socket")
+        .Data("socket_id", handle.socket_id)
+        .Data("idle_ms", idle_ms)
+        .Log();
+    if (auto res = CloseSocket(handle.socket_id); res.IsErr()) {
+      log::Error("Failed to close idle socket")
+          .Data("socket_id", handle.socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+  }
+
+  auto
+  OnHeartbeatTimer(const SocketHandle handle) noexcept -> void {
+    auto socket_info = socket_table_.Find(handle);
+    if (!socket_info) {
+      return;
+    }
+
+    auto& info = socket_info.Unwrap();
+    const auto quiet_ms =
+        GetDependency<TimerService>()->GetNowMs() - info.last_read_ms;
+    info.heartbeat_timer =
+        ScheduleSocketTimer(handle,
+                            options_.heartbeat_interval_ms,
+                            &SocketPoolService::OnHeartbeatTimer);
+    if (quiet_ms < options_.heartbeat_interval_ms) {
+      return;
+    }
+
+    if (auto res = WriteToSocket(
+            handle.socket_id,
+            FlatJson{}.Set("event", EventHeartbeat::kEvent).Take());
+        res.IsErr()) {
+      log::Warn("Failed to send heartbeat")
+          .Data("socket_id", handle.socket_id)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+  }
+
+  SocketPoolOptions options_{};
+  SocketHandoffStats handoff_stats_{};
+  bool is_shutting_down_{false};
   std::unordered_map<std::string /* event */, EventHandler> event_handler_map_;
+
+  /**
+   * Per call site, a failing handler may fire on every event.
+   */
+  static constexpr u32 kErrorLogsPerSecond{10};
 };
 
 }  // namespace kero
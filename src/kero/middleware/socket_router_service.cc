@@ -31,23 +31,60 @@ kero::SocketRouterService::OnCreate() noexcept -> Result<Void> {
             .Take()));
   }
 
+  if (!SubscribeEvent(EventSocketOpenBatch::kEvent)) {
+    return ResultT::Err(Error::From(
+        FlatJson{}
+            .Set("message",
+                 std::string{"Failed to subscribe to socket open batch event"})
+            .Take()));
+  }
+
   return OkVoid();
 }
 
 auto
 kero::SocketRouterService::OnEvent(const std::string& event,
                                    const FlatJson& data) noexcept -> void {
-  if (event != EventSocketOpen::kEvent) {
+  if (event == EventSocketOpen::kEvent) {
+    const auto socket_id_opt = data.TryGet<u64>(EventSocketOpen::kSocketId);
+    if (!socket_id_opt) {
+      log::Error("Failed to get socket id from data").Data("data", data).Log();
+      return;
+    }
+
+    RouteSocket(socket_id_opt.Unwrap());
     return;
   }
 
-  const auto socket_id_opt = data.TryGet<u64>(EventSocketOpen::kSocketId);
-  if (!socket_id_opt) {
-    log::Error("Failed to get socket id from data").Data("data", data).Log();
-    return;
+  if (event == EventSocketOpenBatch::kEvent) {
+    const auto count_opt = data.TryGet<u32>(EventSocketOpenBatch::kCount);
+    if (!count_opt) {
+      log::Error("Failed to get count from data").Data("data", data).Log();
+      return;
+    }
+
+    const auto count = count_opt.Unwrap();
+    for (u32 i = 0; i < count; ++i) {
+      const auto socket_id_opt = data.TryGet<u64>(
+          EventSocketOpenBatch::kSocketIdPrefix + std::to_string(i));
+      if (!socket_id_opt) {
+        log::Error("Failed to get socket id from batch data")
+            .Data("index", i)
+            .Data("data", data)
+            .Log();
+        continue;
+      }
+
+      RouteSocket(socket_id_opt.Unwrap());
+    }
   }
+}
 
-  GetDependency<ActorService>()->SendMail(std::string{target_},
-                                          EventSocketMove::kEvent,
-                                          data.Clone());
+auto
+kero::SocketRouterService::RouteSocket(const SocketId socket_id) noexcept
+    -> void {
+  GetDependency<ActorService>()->SendMail(
+      std::string{target_},
+      EventSocketMove::kEvent,
+      FlatJson{}.Set(EventSocketMove::kSocketId, socket_id).Take());
 }
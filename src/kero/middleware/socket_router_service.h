@@ -22,6 +22,9 @@ class SocketRouterService final : public Service {
           const FlatJson& data) noexcept -> void override;
 
  private:
+  auto
+  RouteSocket(const SocketId socket_id) noexcept -> void;
+
   std::string target_;
 };
 
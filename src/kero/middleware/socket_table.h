@@ -0,0 +1,144 @@
+#ifndef KERO_MIDDLEWARE_SOCKET_TABLE_H
+#define KERO_MIDDLEWARE_SOCKET_TABLE_H
+
+#include <span>
+#include <vector>
+
+#include "kero/core/common.h"
+#include "kero/core/option.h"
+#include "kero/middleware/common.h"
+
+namespace kero {
+
+/**
+ * Names one registration of a socket. The kernel reuses fds as soon as they
+ * are closed, so a handle kept across events must be checked with
+ * `SocketTable::Find(const SocketHandle)` before use.
+ */
+struct SocketHandle {
+  SocketId socket_id{};
+  u32 generation{};
+
+  [[nodiscard]] auto
+  operator==(const SocketHandle& other) const noexcept -> bool = default;
+};
+
+/**
+ * Slot map indexed directly by fd. Every slot keeps a generation which is
+ * bumped on each insert, and live sockets are also kept in a dense list for
+ * iteration.
+ */
+template <typename T>
+class SocketTable final {
+ public:
+  explicit SocketTable() noexcept = default;
+  ~SocketTable() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(SocketTable);
+
+  /**
+   * Returns `None` when the socket is already registered.
+   */
+  [[nodiscard]] auto
+  Insert(const SocketId socket_id,
+         T&& value) noexcept -> Option<SocketHandle> {
+    if (socket_id >= slots_.size()) {
+      slots_.resize(socket_id + 1);
+    }
+
+    auto& slot = slots_[socket_id];
+    if (slot.live) {
+      return None;
+    }
+
+    ++slot.generation;
+    slot.live = true;
+    slot.live_index = static_cast<u32>(live_.size());
+    slot.value = std::move(value);
+    live_.push_back(socket_id);
+    return Option<SocketHandle>::Some(
+        SocketHandle{.socket_id = socket_id, .generation = slot.generation});
+  }
+
+  auto
+  Erase(const SocketId socket_id) noexcept -> bool {
+    if (socket_id >= slots_.size() || !slots_[socket_id].live) {
+      return false;
+    }
+
+    auto& slot = slots_[socket_id];
+    const auto moved_socket_id = live_.back();
+    live_[slot.live_index] = moved_socket_id;
+    slots_[moved_socket_id].live_index = slot.live_index;
+    live_.pop_back();
+
+    slot.live = false;
+    slot.value = T{};
+    return true;
+  }
+
+  [[nodiscard]] auto
+  Find(const SocketId socket_id) noexcept -> OptionRef<T&> {
+    if (socket_id >= slots_.size() || !slots_[socket_id].live) {
+      return None;
+    }
+
+    return OptionRef<T&>::Some(slots_[socket_id].value);
+  }
+
+  [[nodiscard]] auto
+  Find(const SocketHandle handle) noexcept -> OptionRef<T&> {
+    if (handle.socket_id >= slots_.size()) {
+      return None;
+    }
+
+    auto& slot = slots_[handle.socket_id];
+    if (!slot.live || slot.generation != handle.generation) {
+      return None;
+    }
+
+    return OptionRef<T&>::Some(slot.value);
+  }
+
+  [[nodiscard]] auto
+  GetHandle(const SocketId socket_id) const noexcept -> Option<SocketHandle> {
+    if (socket_id >= slots_.size() || !slots_[socket_id].live) {
+      return None;
+    }
+
+    return Option<SocketHandle>::Some(SocketHandle{
+        .socket_id = socket_id, .generation = slots_[socket_id].generation});
+  }
+
+  [[nodiscard]] auto
+  Contains(const SocketId socket_id) const noexcept -> bool {
+    return socket_id < slots_.size() && slots_[socket_id].live;
+  }
+
+  /**
+   * Live sockets in no particular order. Invalidated by `Insert`/`Erase`.
+   */
+  [[nodiscard]] auto
+  GetLive() const noexcept -> std::span<const SocketId> {
+    return live_;
+  }
+
+  [[nodiscard]] auto
+  Size() const noexcept -> size_t {
+    return live_.size();
+  }
+
+ private:
+  struct Slot {
+    T value{};
+    u32 generation{};
+    u32 live_index{};
+    bool live{false};
+  };
+
+  std::vector<Slot> slots_;
+  std::vector<SocketId> live_;
+};
+
+}  // namespace kero
+
+#endif  // KERO_MIDDLEWARE_SOCKET_TABLE_H
@@ -10,6 +10,7 @@
 #include "kero/middleware/common.h"
 #include "kero/middleware/config_service.h"
 #include "kero/middleware/io_event_loop_service.h"
+#include "kero/middleware/tcp_socket_options.h"
 
 using namespace kero;
 
@@ -30,54 +31,58 @@ kero::TcpServerService::OnCreate() noexcept -> Result<Void> {
             .Take()));
   }
 
-  auto port_opt =
-      GetDependency<ConfigService>()->GetConfig().TryGet<u16>("port");
-  if (port_opt.IsNone()) {
-    return ResultT::Err(
-        Error::From(FlatJson{}
-                        .Set("message", std::string{"port not found in config"})
-                        .Take()));
+  const auto& config = GetDependency<ConfigService>()->GetConfig();
+  auto socket_options_res = TcpSocketOptions::FromConfig(config);
+  if (socket_options_res.IsErr()) {
+    return ResultT::Err(socket_options_res.TakeErr());
   }
 
-  const auto port = port_opt.TakeUnwrap();
-  auto server_fd = socket(AF_INET, SOCK_STREAM, 0);
-  if (!Fd::IsValid(server_fd)) {
+  socket_options_ = socket_options_res.TakeOk();
+  auto accept_budget_opt = config.TryGet<u32>("accept_budget");
+  if (accept_budget_opt.IsSome()) {
+    accept_budget_ = accept_budget_opt.TakeUnwrap();
+  }
+
+  if (accept_budget_ == 0) {
     return ResultT::Err(Error::From(
-        Errno::FromErrno()
-            .IntoFlatJson()
-            .Set("message", std::string{"Failed to create server socket"})
+        FlatJson{}
+            .Set("message", std::string{"accept_budget must be positive"})
             .Take()));
   }
 
-  int reuse{1};
-  if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) <
-      0) {
+  auto server_fd = socket(socket_options_.GetFamily(),
+                         SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                         0);
+  if (!Fd::IsValid(server_fd)) {
     return ResultT::Err(Error::From(
         Errno::FromErrno()
             .IntoFlatJson()
-            .Set("message", std::string{"Failed to set socket reuse option"})
+            .Set("message", std::string{"Failed to create server socket"})
             .Take()));
   }
 
-  if (auto res = Fd::UpdateNonBlocking(server_fd); res.IsErr()) {
-    return ResultT::From(Error::From(res.TakeErr()));
+  if (auto res = socket_options_.ApplyToListener(server_fd); res.IsErr()) {
+    return ResultT::Err(res.TakeErr());
+  }
+
+  struct sockaddr_storage server_addr {};
+  auto server_addr_len_res = socket_options_.ToSockAddr(server_addr);
+  if (server_addr_len_res.IsErr()) {
+    return ResultT::Err(server_addr_len_res.TakeErr());
   }
 
-  struct sockaddr_in server_addr {};
-  server_addr.sin_family = AF_INET;
-  server_addr.sin_addr.s_addr = INADDR_ANY;
-  server_addr.sin_port = htons(port);
-  if (bind(server_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) <
-      0) {
+  const auto server_addr_len = server_addr_len_res.TakeOk();
+  if (bind(server_fd, (struct sockaddr*)&server_addr, server_addr_len) < 0) {
     return ResultT::Err(Error::From(
         Errno::FromErrno()
             .IntoFlatJson()
             .Set("message", std::string{"Failed to bind server socket"})
-            .Set("port", static_cast<double>(port))
+            .Set("bind_address", socket_options_.bind_address)
+            .Set("port", static_cast<double>(socket_options_.port))
             .Take()));
   }
 
-  if (listen(server_fd, SOMAXCONN) < 0) {
+  if (listen(server_fd, socket_options_.backlog) < 0) {
     return ResultT::Err(Error::From(
         Errno::FromErrno()
             .IntoFlatJson()
@@ -107,6 +112,25 @@ kero::TcpServerService::OnDestroy() noexcept -> void {
         .Data("error", res.TakeErr())
         .Log();
   }
+
+  server_fd_ = Fd::kUnspecifiedInitialValue;
+}
+
+auto
+kero::TcpServerService::OnShutdown() noexcept -> void {
+  if (!Fd::IsValid(server_fd_)) {
+    return;
+  }
+
+  if (auto res = GetDependency<IoEventLoopService>()->RemoveFd(server_fd_);
+      res.IsErr()) {
+    log::Error("Failed to remove server fd from epoll")
+        .Data("fd", server_fd_)
+        .Data("error", res.TakeErr())
+        .Log();
+  }
+
+  OnDestroy();
 }
 
 auto
@@ -121,36 +145,64 @@ kero::TcpServerService::OnEvent(const std::string& event,
 
     const auto fd = static_cast<int>(socket_id.TakeUnwrap());
     if (fd == server_fd_) {
-      struct sockaddr_in client_addr {};
-      socklen_t addrlen = sizeof(struct sockaddr_in);
-      auto client_fd =
-          accept(server_fd_, (struct sockaddr*)&client_addr, &addrlen);
-      if (!Fd::IsValid(client_fd)) {
-        log::Error("Failed to accept client connection")
-            .Data("server_fd", server_fd_)
-            .Data("errno", Errno::FromErrno())
-            .Log();
-        return;
-      }
+      AcceptPendingConnections();
+    }
+  }
+}
 
-      if (auto res = Fd::UpdateNonBlocking(client_fd); res.IsErr()) {
-        log::Error("Failed to update client fd to non-blocking")
-            .Data("client_fd", client_fd)
-            .Data("error", res.TakeErr())
-            .Log();
-        return;
+auto
+kero::TcpServerService::AcceptPendingConnections() noexcept -> void {
+  // The listen socket is registered level-triggered, so connections left over
+  // once the budget is spent are picked up again on the next tick.
+  FlatJson batch{};
+  u32 count{0};
+  while (count < accept_budget_) {
+    struct sockaddr_storage client_addr {};
+    socklen_t addrlen = sizeof(client_addr);
+    auto client_fd = accept4(server_fd_,
+                             (struct sockaddr*)&client_addr,
+                             &addrlen,
+                             SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (!Fd::IsValid(client_fd)) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
       }
 
-      if (auto res = InvokeEvent(
-              EventSocketOpen::kEvent,
-              FlatJson{}
-                  .Set(EventSocketOpen::kSocketId, static_cast<u64>(client_fd))
-                  .Take());
-          res.IsErr()) {
-        log::Error("Failed to invoke socket open event")
-            .Data("error", res.TakeErr())
-            .Log();
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
       }
+
+      log::Error("Failed to accept client connection")
+          .Data("server_fd", server_fd_)
+          .Data("errno", Errno::FromErrno())
+          .Log();
+      break;
     }
+
+    if (auto res = socket_options_.ApplyToAccepted(client_fd); res.IsErr()) {
+      log::Warn("Failed to apply socket options to client socket")
+          .Data("client_fd", client_fd)
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+
+    (void)batch.Set(
+        EventSocketOpenBatch::kSocketIdPrefix + std::to_string(count),
+        static_cast<u64>(client_fd));
+    ++count;
+  }
+
+  if (count == 0) {
+    return;
+  }
+
+  if (auto res = InvokeEvent(
+          EventSocketOpenBatch::kEvent,
+          batch.Set(EventSocketOpenBatch::kCount, count).Take());
+      res.IsErr()) {
+    log::Error("Failed to invoke socket open batch event")
+        .Data("count", count)
+        .Data("error", res.TakeErr())
+        .Log();
   }
 }
@@ -4,6 +4,7 @@
 #include "kero/core/utils_linux.h"
 #include "kero/engine/service.h"
 #include "kero/middleware/common.h"
+#include "kero/middleware/tcp_socket_options.h"
 
 namespace kero {
 
@@ -21,12 +22,26 @@ class TcpServerService final : public Service {
   virtual auto
   OnDestroy() noexcept -> void override;
 
+  /**
+   * Stops accepting by closing the listen socket, so the kernel refuses new
+   * connections while the rest of the runner drains.
+   */
+  virtual auto
+  OnShutdown() noexcept -> void override;
+
   virtual auto
   OnEvent(const std::string& event,
           const FlatJson& data) noexcept -> void override;
 
  private:
+  auto
+  AcceptPendingConnections() noexcept -> void;
+
+  TcpSocketOptions socket_options_{};
   Fd::Value server_fd_{Fd::kUnspecifiedInitialValue};
+  u32 accept_budget_{kDefaultAcceptBudget};
+
+  static constexpr u32 kDefaultAcceptBudget = 128;
 };
 
 }  // namespace kero
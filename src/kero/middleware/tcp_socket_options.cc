@@ -0,0 +1,281 @@
+#include "tcp_socket_options.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <cstring>
+
+#include "kero/core/flat_json.h"
+#include "kero/core/utils.h"
+
+using namespace kero;
+
+namespace {
+
+template <typename T>
+static auto
+ReadConfig(const FlatJson& config, const std::string& key, T& out) noexcept
+    -> void {
+  auto value = config.TryGet<T>(key);
+  if (value.IsSome()) {
+    out = value.TakeUnwrap();
+  }
+}
+
+static auto
+ReadConfig(const FlatJson& config,
+           const std::string& key,
+           std::string& out) noexcept -> void {
+  const auto value = config.TryGet<std::string>(key);
+  if (value.IsSome()) {
+    out = value.Unwrap();
+  }
+}
+
+[[nodiscard]] static auto
+SetOption(const Fd::Value fd,
+          const int level,
+          const int name,
+          const int value,
+          const std::string_view option) noexcept -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  if (setsockopt(fd, level, name, &value, sizeof(value)) < 0) {
+    return ResultT::Err(
+        Error::From(TcpSocketOptions::kSetOptionFailed,
+                    Errno::FromErrno()
+                        .IntoFlatJson()
+                        .Set("message", "Failed to set socket option")
+                        .Set("option", option)
+                        .Set("value", value)
+                        .Set("fd", fd)
+                        .Take()));
+  }
+
+  return OkVoid();
+}
+
+}  // namespace
+
+auto
+kero::TcpSocketOptions::GetFamily() const noexcept -> int {
+  if (ipv6 || bind_address.find(':') != std::string::npos) {
+    return AF_INET6;
+  }
+
+  return AF_INET;
+}
+
+auto
+kero::TcpSocketOptions::ToSockAddr(struct sockaddr_storage& addr) const noexcept
+    -> Result<u32> {
+  using ResultT = Result<u32>;
+
+  std::memset(&addr, 0, sizeof(addr));
+  if (GetFamily() == AF_INET6) {
+    auto& addr6 = reinterpret_cast<struct sockaddr_in6&>(addr);
+    addr6.sin6_family = AF_INET6;
+    addr6.sin6_port = htons(port);
+    addr6.sin6_addr = in6addr_any;
+    if (!bind_address.empty() &&
+        inet_pton(AF_INET6, bind_address.data(), &addr6.sin6_addr) != 1) {
+      return ResultT::Err(Error::From(
+          kInvalidBindAddress,
+          FlatJson{}.Set("bind_address", bind_address).Take()));
+    }
+
+    return ResultT::Ok(sizeof(struct sockaddr_in6));
+  }
+
+  auto& addr4 = reinterpret_cast<struct sockaddr_in&>(addr);
+  addr4.sin_family = AF_INET;
+  addr4.sin_port = htons(port);
+  addr4.sin_addr.s_addr = INADDR_ANY;
+  if (!bind_address.empty() &&
+      inet_pton(AF_INET, bind_address.data(), &addr4.sin_addr) != 1) {
+    return ResultT::Err(
+        Error::From(kInvalidBindAddress,
+                    FlatJson{}.Set("bind_address", bind_address).Take()));
+  }
+
+  return ResultT::Ok(sizeof(struct sockaddr_in));
+}
+
+auto
+kero::TcpSocketOptions::ApplyToListener(const Fd::Value fd) const noexcept
+    -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  if (auto res = SetOption(fd, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+      res.IsErr()) {
+    return ResultT::Err(res.TakeErr());
+  }
+
+  if (reuse_port) {
+    // Every runner that binds the same port with SO_REUSEPORT gets its own
+    // accept queue, and the kernel spreads incoming connections across them.
+    if (auto res = SetOption(fd, SOL_SOCKET, SO_REUSEPORT, 1, "SO_REUSEPORT");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (GetFamily() == AF_INET6) {
+    if (auto res = SetOption(
+            fd, IPPROTO_IPV6, IPV6_V6ONLY, ipv6_only ? 1 : 0, "IPV6_V6ONLY");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (send_buffer_size > 0) {
+    if (auto res =
+            SetOption(fd, SOL_SOCKET, SO_SNDBUF, send_buffer_size, "SO_SNDBUF");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (receive_buffer_size > 0) {
+    if (auto res = SetOption(
+            fd, SOL_SOCKET, SO_RCVBUF, receive_buffer_size, "SO_RCVBUF");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (tcp_defer_accept > 0) {
+    // Wake the acceptor only once the client has sent its first bytes.
+    if (auto res = SetOption(fd,
+                             IPPROTO_TCP,
+                             TCP_DEFER_ACCEPT,
+                             tcp_defer_accept,
+                             "TCP_DEFER_ACCEPT");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (tcp_fastopen > 0) {
+    if (auto res = SetOption(
+            fd, IPPROTO_TCP, TCP_FASTOPEN, tcp_fastopen, "TCP_FASTOPEN");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (incoming_cpu != kNoIncomingCpu) {
+    // Only a hint: the kernel prefers this listener for connections whose
+    // packets are processed on the same cpu.
+    if (auto res = SetOption(
+            fd, SOL_SOCKET, SO_INCOMING_CPU, incoming_cpu, "SO_INCOMING_CPU");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  return OkVoid();
+}
+
+auto
+kero::TcpSocketOptions::ApplyToAccepted(const Fd::Value fd) const noexcept
+    -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  if (tcp_nodelay) {
+    if (auto res = SetOption(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (tcp_quickack) {
+    // Covers the first reads only, see `SocketPoolOptions::tcp_quickack`.
+    if (auto res = SetOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (!keepalive) {
+    return OkVoid();
+  }
+
+  if (auto res = SetOption(fd, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE");
+      res.IsErr()) {
+    return ResultT::Err(res.TakeErr());
+  }
+
+  if (keepalive_idle > 0) {
+    if (auto res = SetOption(
+            fd, IPPROTO_TCP, TCP_KEEPIDLE, keepalive_idle, "TCP_KEEPIDLE");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (keepalive_interval > 0) {
+    if (auto res = SetOption(fd,
+                             IPPROTO_TCP,
+                             TCP_KEEPINTVL,
+                             keepalive_interval,
+                             "TCP_KEEPINTVL");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  if (keepalive_count > 0) {
+    if (auto res = SetOption(
+            fd, IPPROTO_TCP, TCP_KEEPCNT, keepalive_count, "TCP_KEEPCNT");
+        res.IsErr()) {
+      return ResultT::Err(res.TakeErr());
+    }
+  }
+
+  return OkVoid();
+}
+
+auto
+kero::TcpSocketOptions::FromConfig(const FlatJson& config) noexcept
+    -> Result<TcpSocketOptions> {
+  using ResultT = Result<TcpSocketOptions>;
+
+  TcpSocketOptions options{};
+  auto port_opt = config.TryGet<u16>("port");
+  if (port_opt.IsNone()) {
+    return ResultT::Err(
+        Error::From(FlatJson{}
+                        .Set("message", std::string{"port not found in config"})
+                        .Take()));
+  }
+
+  options.port = port_opt.TakeUnwrap();
+  ReadConfig(config, "bind_address", options.bind_address);
+  ReadConfig(config, "ipv6", options.ipv6);
+  ReadConfig(config, "ipv6_only", options.ipv6_only);
+  ReadConfig(config, "backlog", options.backlog);
+  ReadConfig(config, "reuse_port", options.reuse_port);
+  ReadConfig(config, "incoming_cpu", options.incoming_cpu);
+  ReadConfig(config, "tcp_nodelay", options.tcp_nodelay);
+  ReadConfig(config, "tcp_quickack", options.tcp_quickack);
+  ReadConfig(config, "send_buffer_size", options.send_buffer_size);
+  ReadConfig(config, "receive_buffer_size", options.receive_buffer_size);
+  ReadConfig(config, "keepalive", options.keepalive);
+  ReadConfig(config, "keepalive_idle", options.keepalive_idle);
+  ReadConfig(config, "keepalive_interval", options.keepalive_interval);
+  ReadConfig(config, "keepalive_count", options.keepalive_count);
+  ReadConfig(config, "tcp_defer_accept", options.tcp_defer_accept);
+  ReadConfig(config, "tcp_fastopen", options.tcp_fastopen);
+
+  if (options.backlog <= 0) {
+    return ResultT::Err(Error::From(
+        FlatJson{}
+            .Set("message", std::string{"backlog must be positive"})
+            .Set("backlog", options.backlog)
+            .Take()));
+  }
+
+  return ResultT::Ok(std::move(options));
+}
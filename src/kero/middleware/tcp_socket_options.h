@@ -0,0 +1,79 @@
+#ifndef KERO_MIDDLEWARE_TCP_SOCKET_OPTIONS_H
+#define KERO_MIDDLEWARE_TCP_SOCKET_OPTIONS_H
+
+#include <sys/socket.h>
+
+#include <string>
+
+#include "kero/core/common.h"
+#include "kero/core/result.h"
+#include "kero/core/utils_linux.h"
+
+namespace kero {
+
+/**
+ * Socket options profile shared by the listen socket and every accepted
+ * socket of a `TcpServerService`. All values are read from the config; a
+ * missing key keeps the default below, and a zero size or timer keeps the
+ * kernel default.
+ */
+struct TcpSocketOptions final {
+  enum : Error::Code {
+    kInvalidBindAddress = 1,
+    kSetOptionFailed,
+  };
+
+  std::string bind_address{};
+  u16 port{};
+  bool ipv6{false};
+  bool ipv6_only{false};
+  i32 backlog{kDefaultBacklog};
+  bool reuse_port{false};
+  i32 incoming_cpu{kNoIncomingCpu};
+
+  bool tcp_nodelay{true};
+  bool tcp_quickack{false};
+  i32 send_buffer_size{0};
+  i32 receive_buffer_size{0};
+
+  bool keepalive{false};
+  i32 keepalive_idle{0};
+  i32 keepalive_interval{0};
+  i32 keepalive_count{0};
+
+  i32 tcp_defer_accept{0};
+  i32 tcp_fastopen{0};
+
+  explicit TcpSocketOptions() noexcept = default;
+  ~TcpSocketOptions() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(TcpSocketOptions);
+
+  [[nodiscard]] auto
+  GetFamily() const noexcept -> int;
+
+  /**
+   * Fills `addr` from `bind_address`/`port` and returns the address length.
+   */
+  [[nodiscard]] auto
+  ToSockAddr(struct sockaddr_storage& addr) const noexcept -> Result<u32>;
+
+  /**
+   * Options which must be set before `bind`/`listen`. Buffer sizes set here
+   * are inherited by accepted sockets.
+   */
+  [[nodiscard]] auto
+  ApplyToListener(const Fd::Value fd) const noexcept -> Result<Void>;
+
+  [[nodiscard]] auto
+  ApplyToAccepted(const Fd::Value fd) const noexcept -> Result<Void>;
+
+  [[nodiscard]] static auto
+  FromConfig(const FlatJson& config) noexcept -> Result<TcpSocketOptions>;
+
+  static constexpr i32 kDefaultBacklog = SOMAXCONN;
+  static constexpr i32 kNoIncomingCpu = -1;
+};
+
+}  // namespace kero
+
+#endif  // KERO_MIDDLEWARE_TCP_SOCKET_OPTIONS_H
@@ -0,0 +1,180 @@
+#include "timer_service.h"
+
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "kero/core/utils.h"
+#include "kero/core/utils_linux.h"
+#include "kero/engine/runner_context.h"
+#include "kero/log/log_builder.h"
+#include "kero/middleware/common.h"
+#include "kero/middleware/io_event_loop_service.h"
+
+using namespace kero;
+
+namespace {
+
+[[nodiscard]] static auto
+MonotonicMs() noexcept -> u64 {
+  struct timespec now {};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<u64>(now.tv_sec) * 1000 +
+         static_cast<u64>(now.tv_nsec) / 1000000;
+}
+
+}  // namespace
+
+kero::TimerService::TimerService(
+    const Borrow<RunnerContext> runner_context) noexcept
+    : Service{runner_context, {kServiceKindId_IoEventLoop}} {}
+
+auto
+kero::TimerService::OnCreate() noexcept -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  if (auto res = SubscribeEvent(EventSocketRead::kEvent); res.IsErr()) {
+    return ResultT::Err(res.TakeErr());
+  }
+
+  const auto timer_fd =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (!Fd::IsValid(timer_fd)) {
+    return ResultT::Err(Error::From(
+        kCreateTimerFdFailed,
+        Errno::FromErrno()
+            .IntoFlatJson()
+            .Set("message", std::string{"Failed to create timer fd"})
+            .Take()));
+  }
+
+  if (auto res =
+          GetDependency<IoEventLoopService>()->AddFd(timer_fd, {.in = true});
+      res.IsErr()) {
+    (void)Fd::Close(timer_fd);
+    return ResultT::Err(res.TakeErr());
+  }
+
+  timer_fd_ = timer_fd;
+  wheel_.Reset(MonotonicMs() / kTickMs);
+  return OkVoid();
+}
+
+auto
+kero::TimerService::OnDestroy() noexcept -> void {
+  if (auto res = UnsubscribeEvent(EventSocketRead::kEvent); res.IsErr()) {
+    log::Error("Failed to unsubscribe event")
+        .Data("event", EventSocketRead::kEvent)
+        .Data("error", res.TakeErr())
+        .Log();
+  }
+
+  if (!Fd::IsValid(timer_fd_)) {
+    return;
+  }
+
+  if (auto res = GetDependency<IoEventLoopService>()->RemoveFd(timer_fd_);
+      res.IsErr()) {
+    log::Error("Failed to remove timer fd from epoll")
+        .Data("fd", timer_fd_)
+        .Data("error", res.TakeErr())
+        .Log();
+  }
+
+  if (auto res = Fd::Close(timer_fd_); res.IsErr()) {
+    log::Error("Failed to close timer fd")
+        .Data("fd", timer_fd_)
+        .Data("error", res.TakeErr())
+        .Log();
+  }
+
+  timer_fd_ = Fd::kUnspecifiedInitialValue;
+}
+
+auto
+kero::TimerService::OnEvent(const std::string& event,
+                            const FlatJson& data) noexcept -> void {
+  if (event != EventSocketRead::kEvent) {
+    return;
+  }
+
+  const auto socket_id = data.TryGet<u64>(EventSocketRead::kSocketId);
+  if (!socket_id || static_cast<Fd::Value>(socket_id.Unwrap()) != timer_fd_) {
+    return;
+  }
+
+  // The expiration count is not used, ticks are taken from the clock so a late
+  // wakeup does not let the wheel drift.
+  u64 expirations{};
+  if (read(timer_fd_, &expirations, sizeof(expirations)) !=
+      sizeof(expirations)) {
+    return;
+  }
+
+  wheel_.Advance(MonotonicMs() / kTickMs - wheel_.GetNowTick());
+  if (wheel_.GetPendingCount() == 0) {
+    if (auto res = Arm(false); res.IsErr()) {
+      log::Error("Failed to disarm timer fd")
+          .Data("error", res.TakeErr())
+          .Log();
+    }
+  }
+}
+
+auto
+kero::TimerService::Schedule(const u64 delay_ms,
+                             Callback&& callback) noexcept -> TimerId {
+  if (!armed_) {
+    // Nothing is linked, so the wheel can jump straight to the clock.
+    wheel_.Reset(MonotonicMs() / kTickMs);
+    if (auto res = Arm(true); res.IsErr()) {
+      log::Error("Failed to arm timer fd").Data("error", res.TakeErr()).Log();
+      return kInvalidTimerId;
+    }
+  }
+
+  return wheel_.Schedule((delay_ms + kTickMs - 1) / kTickMs,
+                         std::move(callback));
+}
+
+auto
+kero::TimerService::Cancel(const TimerId timer_id) noexcept -> bool {
+  return wheel_.Cancel(timer_id);
+}
+
+auto
+kero::TimerService::GetNowMs() const noexcept -> u64 {
+  return MonotonicMs();
+}
+
+auto
+kero::TimerService::GetPendingCount() const noexcept -> size_t {
+  return wheel_.GetPendingCount();
+}
+
+auto
+kero::TimerService::Arm(const bool armed) noexcept -> Result<Void> {
+  using ResultT = Result<Void>;
+
+  if (armed_ == armed) {
+    return OkVoid();
+  }
+
+  struct itimerspec spec {};
+  if (armed) {
+    spec.it_interval.tv_nsec = static_cast<long>(kTickMs * 1000000);
+    spec.it_value = spec.it_interval;
+  }
+
+  if (timerfd_settime(timer_fd_, 0, &spec, nullptr) == -1) {
+    return ResultT::Err(Error::From(
+        kSetTimerFdFailed,
+        Errno::FromErrno()
+            .IntoFlatJson()
+            .Set("message", std::string{"Failed to set timer fd"})
+            .Take()));
+  }
+
+  armed_ = armed;
+  return OkVoid();
+}
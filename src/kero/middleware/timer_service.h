@@ -0,0 +1,78 @@
+#ifndef KERO_MIDDLEWARE_TIMER_SERVICE_H
+#define KERO_MIDDLEWARE_TIMER_SERVICE_H
+
+#include "kero/core/utils_linux.h"
+#include "kero/engine/service.h"
+#include "kero/middleware/common.h"
+#include "kero/middleware/timing_wheel.h"
+
+namespace kero {
+
+/**
+ * One-shot timers of a runner, on a `TimingWheel` with a tick of `kTickMs`.
+ *
+ * The wheel is driven by a single `timerfd` in the epoll set of the runner,
+ * which is armed only while timers are pending.
+ */
+class TimerService final : public Service {
+ public:
+  using Callback = TimingWheel::Callback;
+
+  enum : Error::Code {
+    kCreateTimerFdFailed = 1,
+    kSetTimerFdFailed,
+  };
+
+  explicit TimerService(const Borrow<RunnerContext> runner_context) noexcept;
+  virtual ~TimerService() noexcept override = default;
+  KERO_CLASS_KIND_MOVABLE(TimerService);
+  KERO_SERVICE_KIND(kServiceKindId_Timer, "timer");
+
+  [[nodiscard]] virtual auto
+  OnCreate() noexcept -> Result<Void> override;
+
+  virtual auto
+  OnDestroy() noexcept -> void override;
+
+  virtual auto
+  OnEvent(const std::string& event,
+          const FlatJson& data) noexcept -> void override;
+
+  /**
+   * Runs `callback` once, `delay_ms` (rounded up to a tick) from now. Delays
+   * beyond the range of the wheel are clamped to it.
+   */
+  [[nodiscard]] auto
+  Schedule(const u64 delay_ms, Callback&& callback) noexcept -> TimerId;
+
+  /**
+   * Returns `false` when the timer already fired or was cancelled.
+   */
+  auto
+  Cancel(const TimerId timer_id) noexcept -> bool;
+
+  /**
+   * Milliseconds of `CLOCK_MONOTONIC`, read on every call. Only the
+   * difference between two values means something.
+   */
+  [[nodiscard]] auto
+  GetNowMs() const noexcept -> u64;
+
+  [[nodiscard]] auto
+  GetPendingCount() const noexcept -> size_t;
+
+  static constexpr TimerId kInvalidTimerId{TimingWheel::kInvalidTimerId};
+  static constexpr u64 kTickMs{10};
+
+ private:
+  [[nodiscard]] auto
+  Arm(const bool armed) noexcept -> Result<Void>;
+
+  TimingWheel wheel_{};
+  Fd::Value timer_fd_{Fd::kUnspecifiedInitialValue};
+  bool armed_{false};
+};
+
+}  // namespace kero
+
+#endif  // KERO_MIDDLEWARE_TIMER_SERVICE_H
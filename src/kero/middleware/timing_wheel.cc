@@ -0,0 +1,171 @@
+#include "timing_wheel.h"
+
+#include <algorithm>
+
+using namespace kero;
+
+kero::TimingWheel::TimingWheel() noexcept {
+  buckets_.fill(kNil);
+}
+
+auto
+kero::TimingWheel::Schedule(const u64 delay_ticks,
+                            Callback&& callback) noexcept -> TimerId {
+  u32 index{};
+  if (free_head_ != kNil) {
+    index = free_head_;
+    free_head_ = nodes_[index].next;
+  } else {
+    index = static_cast<u32>(nodes_.size());
+    nodes_.emplace_back();
+  }
+
+  auto& node = nodes_[index];
+  node.callback = std::move(callback);
+  node.expires =
+      now_tick_ + std::min(std::max(delay_ticks, u64{1}), kMaxDelayTicks);
+  ++node.generation;
+  Link(index);
+  ++pending_count_;
+
+  return (static_cast<TimerId>(node.generation) << 32) | index;
+}
+
+auto
+kero::TimingWheel::Cancel(const TimerId timer_id) noexcept -> bool {
+  const auto index = static_cast<u32>(timer_id & 0xffffffff);
+  const auto generation = static_cast<u32>(timer_id >> 32);
+  if (index >= nodes_.size()) {
+    return false;
+  }
+
+  const auto& node = nodes_[index];
+  if (node.bucket == kNil || node.generation != generation) {
+    return false;
+  }
+
+  Unlink(index);
+  Release(index);
+  return true;
+}
+
+auto
+kero::TimingWheel::Advance(const u64 ticks) noexcept -> void {
+  now_tick_ += ticks;
+  while (next_tick_ <= now_tick_) {
+    const auto slot = static_cast<u32>(next_tick_ & (kSlotCount - 1));
+    if (slot == 0) {
+      for (u32 level = 1; level < kLevelCount; ++level) {
+        const auto upper_slot = static_cast<u32>(
+            (next_tick_ >> (kSlotBits * level)) & (kSlotCount - 1));
+        if (Cascade(level, upper_slot) != 0) {
+          break;
+        }
+      }
+    }
+
+    for (auto index = buckets_[slot]; index != kNil;
+         index = nodes_[index].next) {
+      nodes_[index].bucket = kExpiredBucket;
+    }
+
+    buckets_[kExpiredBucket] = buckets_[slot];
+    buckets_[slot] = kNil;
+    ++next_tick_;
+
+    while (buckets_[kExpiredBucket] != kNil) {
+      const auto index = buckets_[kExpiredBucket];
+      auto callback = std::move(nodes_[index].callback);
+      Unlink(index);
+      Release(index);
+      callback();
+    }
+  }
+}
+
+auto
+kero::TimingWheel::Cascade(const u32 level, const u32 slot) noexcept -> u32 {
+  const auto bucket = level * kSlotCount + slot;
+  auto index = buckets_[bucket];
+  buckets_[bucket] = kNil;
+  while (index != kNil) {
+    const auto next = nodes_[index].next;
+    Link(index);
+    index = next;
+  }
+
+  return slot;
+}
+
+auto
+kero::TimingWheel::Link(const u32 index) noexcept -> void {
+  const auto expires = std::max(nodes_[index].expires, next_tick_);
+  const auto delta = expires - next_tick_;
+
+  u32 level{};
+  while (level + 1 < kLevelCount &&
+         delta >= (u64{1} << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+
+  const auto slot =
+      static_cast<u32>((expires >> (kSlotBits * level)) & (kSlotCount - 1));
+  LinkToBucket(index, level * kSlotCount + slot);
+}
+
+auto
+kero::TimingWheel::LinkToBucket(const u32 index,
+                                 const u32 bucket) noexcept -> void {
+  auto& node = nodes_[index];
+  node.bucket = bucket;
+  node.prev = kNil;
+  node.next = buckets_[bucket];
+  if (node.next != kNil) {
+    nodes_[node.next].prev = index;
+  }
+
+  buckets_[bucket] = index;
+}
+
+auto
+kero::TimingWheel::Unlink(const u32 index) noexcept -> void {
+  auto& node = nodes_[index];
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    buckets_[node.bucket] = node.next;
+  }
+
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+
+  node.prev = kNil;
+  node.next = kNil;
+  node.bucket = kNil;
+}
+
+auto
+kero::TimingWheel::Release(const u32 index) noexcept -> void {
+  auto& node = nodes_[index];
+  node.callback = nullptr;
+  node.next = free_head_;
+  free_head_ = index;
+  --pending_count_;
+}
+
+auto
+kero::TimingWheel::Reset(const u64 now_tick) noexcept -> void {
+  now_tick_ = now_tick;
+  next_tick_ = now_tick;
+}
+
+auto
+kero::TimingWheel::GetNowTick() const noexcept -> u64 {
+  return now_tick_;
+}
+
+auto
+kero::TimingWheel::GetPendingCount() const noexcept -> size_t {
+  return pending_count_;
+}
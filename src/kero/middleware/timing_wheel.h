@@ -0,0 +1,119 @@
+#ifndef KERO_MIDDLEWARE_TIMING_WHEEL_H
+#define KERO_MIDDLEWARE_TIMING_WHEEL_H
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "kero/core/common.h"
+
+namespace kero {
+
+using TimerId = u64;
+
+/**
+ * One-shot timers on a hierarchical timing wheel, counted in ticks. The clock
+ * is the caller's: it moves the wheel with `Advance`, see `TimerService`.
+ *
+ * The wheel has `kLevelCount` levels of `kSlotCount` slots, a slot of level
+ * `n` spans `kSlotCount^n` ticks. Timers live in a slab and are linked into
+ * their slot, so scheduling and cancelling are O(1); a tick only visits the
+ * timers due in it, plus a cascade of one upper slot every `kSlotCount` ticks.
+ */
+class TimingWheel final {
+ public:
+  using Callback = std::function<void()>;
+
+  explicit TimingWheel() noexcept;
+  ~TimingWheel() noexcept = default;
+  KERO_CLASS_KIND_MOVABLE(TimingWheel);
+
+  /**
+   * Runs `callback` once, `delay_ticks` after the current tick. Delays are
+   * at least one tick, and those beyond the range of the wheel are clamped to
+   * it.
+   */
+  [[nodiscard]] auto
+  Schedule(const u64 delay_ticks, Callback&& callback) noexcept -> TimerId;
+
+  /**
+   * Returns `false` when the timer already fired or was cancelled.
+   */
+  auto
+  Cancel(const TimerId timer_id) noexcept -> bool;
+
+  /**
+   * Moves the wheel `ticks` forward, running every timer due on the way.
+   * Callbacks may schedule or cancel timers.
+   */
+  auto
+  Advance(const u64 ticks) noexcept -> void;
+
+  /**
+   * Sets the current tick. Only while no timer is pending, as their expiry
+   * would not be moved.
+   */
+  auto
+  Reset(const u64 now_tick) noexcept -> void;
+
+  [[nodiscard]] auto
+  GetNowTick() const noexcept -> u64;
+
+  [[nodiscard]] auto
+  GetPendingCount() const noexcept -> size_t;
+
+  static constexpr TimerId kInvalidTimerId{0};
+  static constexpr u32 kSlotBits{6};
+  static constexpr u32 kSlotCount{1 << kSlotBits};
+  static constexpr u32 kLevelCount{4};
+  static constexpr u64 kMaxDelayTicks{(u64{1} << (kSlotBits * kLevelCount)) -
+                                      1};
+
+ private:
+  struct Node {
+    Callback callback{};
+    u64 expires{};
+    u32 prev{kNil};
+    u32 next{kNil};
+    u32 bucket{kNil};
+    u32 generation{};
+  };
+
+  auto
+  Cascade(const u32 level, const u32 slot) noexcept -> u32;
+
+  auto
+  Link(const u32 index) noexcept -> void;
+
+  auto
+  LinkToBucket(const u32 index, const u32 bucket) noexcept -> void;
+
+  auto
+  Unlink(const u32 index) noexcept -> void;
+
+  auto
+  Release(const u32 index) noexcept -> void;
+
+  static constexpr u32 kNil{~u32{0}};
+
+  /**
+   * Due timers are moved here before running, so a callback may cancel any
+   * of them or schedule new ones.
+   */
+  static constexpr u32 kExpiredBucket{kSlotCount * kLevelCount};
+
+  std::vector<Node> nodes_;
+  std::array<u32, kExpiredBucket + 1> buckets_{};
+  u32 free_head_{kNil};
+  size_t pending_count_{};
+
+  /**
+   * Ticks elapsed so far, and the next tick the wheel has to run.
+   */
+  u64 now_tick_{};
+  u64 next_tick_{};
+};
+
+}  // namespace kero
+
+#endif  // KERO_MIDDLEWARE_TIMING_WHEEL_H